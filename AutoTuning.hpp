@@ -0,0 +1,574 @@
+#ifndef AUTO_TUNING_HPP
+#define AUTO_TUNING_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Matrix.hpp"
+
+// Size-dependent policy selection. AutoTunedPolicies<T> replaces the multiplication, LU,
+// QR and Cholesky policies with AutoTuned dispatchers. Each one ranks its candidates by
+// measured run time per power-of-two size bucket, the first time a bucket is needed or
+// when calibrateAutoTuning<T>() is called. The rankings are kept in a tuning file so later
+// processes start with the table already filled in: MATRIX_AUTOTUNE_FILE if set, else
+// matrix_autotune.txt in $XDG_CACHE_HOME or, failing that, $HOME/.cache. An empty
+// MATRIX_AUTOTUNE_FILE, or AutoTuneTable::setPath(""), keeps them in memory only.
+
+// Bucket b holds sizes in [2^b, 2^(b+1)); larger sizes share the last bucket, timed at 2^MaxCalibrationBucket
+constexpr int MaxCalibrationBucket = 9;
+
+inline int autoTuneBucket(int size) {
+    int bucket = 0;
+    while (bucket < MaxCalibrationBucket && (2 << bucket) <= size) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+// Candidate timings of one operation at one bucket, fastest first. A negative time marks
+// a candidate that was not timed because it was far behind at the previous bucket or not
+// applicable to the sample input.
+struct AutoTuneEntry {
+    std::vector<std::pair<std::string, double>> ranking;
+};
+
+class AutoTuneTable {
+public:
+    static AutoTuneTable& instance() {
+        static AutoTuneTable table;
+        return table;
+    }
+
+    bool find(const std::string& key, AutoTuneEntry& entry) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            return false;
+        }
+        entry = it->second;
+        return true;
+    }
+
+    void store(const std::string& key, const AutoTuneEntry& entry) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries[key] = entry;
+        save();
+    }
+
+    // Switches to another tuning file and loads it; already resolved dispatch decisions are kept
+    void setPath(const std::string& newPath) {
+        std::lock_guard<std::mutex> lock(mutex);
+        path = newPath;
+        entries.clear();
+        load();
+    }
+
+    const std::string& filePath() const {
+        return path;
+    }
+
+private:
+    AutoTuneTable() : path(defaultPath()) {
+        load();
+    }
+
+    static std::string defaultPath() {
+        if (const char* configured = std::getenv("MATRIX_AUTOTUNE_FILE")) {
+            return configured;
+        }
+        // The XDG base directory spec says to ignore relative paths
+        const char* cache = std::getenv("XDG_CACHE_HOME");
+        if (cache != nullptr && cache[0] == '/') {
+            return (std::filesystem::path(cache) / "matrix_autotune.txt").string();
+        }
+        const char* home = std::getenv("HOME");
+        if (home != nullptr && home[0] != '\0') {
+            return (std::filesystem::path(home) / ".cache" / "matrix_autotune.txt").string();
+        }
+        return "";
+    }
+
+    // One line per entry: "<type> <operation> <bucket> <name>:<ns>,<name>:<ns>,..."
+    void load() {
+        if (path.empty()) {
+            return;
+        }
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream fields(line);
+            std::string type, operation, bucket, ranking;
+            if (!(fields >> type >> operation >> bucket >> ranking)) continue;
+
+            AutoTuneEntry entry;
+            std::istringstream items(ranking);
+            std::string item;
+            while (std::getline(items, item, ',')) {
+                std::size_t colon = item.find(':');
+                if (colon == std::string::npos) continue;
+                entry.ranking.emplace_back(item.substr(0, colon), std::atof(item.c_str() + colon + 1));
+            }
+            entries[type + " " + operation + " " + bucket] = entry;
+        }
+    }
+
+    void save() const {
+        if (path.empty()) {
+            return;
+        }
+        std::error_code ignored;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ignored);
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary);
+            if (!file) {
+                return;
+            }
+            file << "# matrix autotune table: <type> <operation> <size bucket> <policy>:<ns>,...\n";
+            for (const auto& [key, entry] : entries) {
+                file << key << " ";
+                for (std::size_t i = 0; i < entry.ranking.size(); ++i) {
+                    file << (i ? "," : "") << entry.ranking[i].first << ":" << entry.ranking[i].second;
+                }
+                file << "\n";
+            }
+        }
+        std::rename(temporary.c_str(), path.c_str());
+    }
+
+    mutable std::mutex mutex;
+    std::map<std::string, AutoTuneEntry> entries;
+    std::string path;
+};
+
+//====================CANDIDATES====================================
+
+template<typename T>
+std::vector<std::vector<T>> randomDense(int n, std::mt19937& rng) {
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::vector<std::vector<T>> matrix(n, std::vector<T>(n));
+    for (auto& row : matrix) {
+        for (T& value : row) {
+            value = static_cast<T>(distribution(rng));
+        }
+    }
+    return matrix;
+}
+
+// Symmetric and strictly diagonally dominant: positive definite, and safe for LU without pivoting
+template<typename T>
+std::vector<std::vector<T>> diagonallyDominantDense(int n, std::mt19937& rng) {
+    std::vector<std::vector<T>> matrix = randomDense<T>(n, rng);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < i; ++j) {
+            matrix[i][j] = matrix[j][i];
+        }
+        matrix[i][i] = static_cast<T>(n + 1);
+    }
+    return matrix;
+}
+
+template<typename T>
+struct MultiplicationTuning {
+    using Dense = std::vector<std::vector<T>>;
+    using Result = Dense;
+
+    struct Candidate {
+        const char* name;
+        bool (*applicable)(const Dense&, const Dense&);
+        Result (*call)(const Dense&, const Dense&);
+    };
+
+    static constexpr const char* operation = "multiply";
+
+    // The first candidate must accept every input
+    static const std::vector<Candidate>& candidates() {
+        static const std::vector<Candidate> list = {
+            {"Standard", always, StandardMatrixMultiplication<T>::calculate},
+            {"Blocked16", always, BlockedMatrixMultiplication<T, 16>::calculate},
+            {"Blocked32", always, BlockedMatrixMultiplication<T, 32>::calculate},
+            {"Blocked64", always, BlockedMatrixMultiplication<T, 64>::calculate},
+            {"Blocked128", always, BlockedMatrixMultiplication<T, 128>::calculate},
+            {"Strassen", squarePowerOfTwo, StrassenMultiplication<T>::calculate},
+        };
+        return list;
+    }
+
+    static int size(const Dense& A, const Dense& B) {
+        return std::max({static_cast<int>(A.size()), static_cast<int>(A[0].size()), static_cast<int>(B[0].size())});
+    }
+
+    static std::tuple<Dense, Dense> sampleInput(int n, std::mt19937& rng) {
+        return {randomDense<T>(n, rng), randomDense<T>(n, rng)};
+    }
+
+private:
+    static bool always(const Dense&, const Dense&) {
+        return true;
+    }
+
+    static bool squarePowerOfTwo(const Dense& A, const Dense& B) {
+        int n = A.size();
+        return (n & (n - 1)) == 0 && static_cast<int>(A[0].size()) == n && static_cast<int>(B.size()) == n && static_cast<int>(B[0].size()) == n;
+    }
+};
+
+// Only policies that return L * U = A without permutations are candidates, and Crout's
+// factors are rescaled so that L carries the unit diagonal as with Doolittle. The LU
+// factorization with unit lower L is unique, so the result of Matrix::luDecomposition
+// (and what luUpdate expects of it) does not depend on which one is picked.
+template<typename T>
+struct LUTuning {
+    using Dense = std::vector<std::vector<T>>;
+    using Result = std::tuple<Dense, Dense, std::vector<T>, std::vector<T>>;
+
+    struct Candidate {
+        const char* name;
+        bool (*applicable)(const Dense&);
+        Result (*call)(const Dense&);
+    };
+
+    static constexpr const char* operation = "lu";
+
+    static const std::vector<Candidate>& candidates() {
+        static const std::vector<Candidate> list = {
+            {"Doolittle", always, Doolittle<T>::calculate},
+            {"Crout", always, unitLowerCrout},
+        };
+        return list;
+    }
+
+    static int size(const Dense& A) {
+        return A.size();
+    }
+
+    static std::tuple<Dense> sampleInput(int n, std::mt19937& rng) {
+        return {diagonallyDominantDense<T>(n, rng)};
+    }
+
+private:
+    static bool always(const Dense&) {
+        return true;
+    }
+
+    // Crout returns A = L' U' with a unit upper U'; with D = diag(L') this is L = L' D^-1, U = D U'
+    static Result unitLowerCrout(const Dense& A) {
+        auto [L, U, rowPermutation, colPermutation] = Crout<T>::calculate(A);
+        int n = L.size();
+        for (int k = 0; k < n; ++k) {
+            T pivot = L[k][k];
+            for (int i = k; i < n; ++i) {
+                L[i][k] /= pivot;
+            }
+            for (int j = k; j < n; ++j) {
+                U[k][j] *= pivot;
+            }
+        }
+        return {L, U, rowPermutation, colPermutation};
+    }
+};
+
+// Every candidate's factors are normalized to a non-negative diagonal of R, which makes R and
+// the leading min(rows, cols) columns of Q unique for a matrix of full rank. The remaining
+// columns of a full Q are any orthonormal basis of the complement, so only Householder
+// competes on tall inputs, and GramSchmidt (which returns a thin Q) only on square ones.
+template<typename T>
+struct QRTuning {
+    using Dense = std::vector<std::vector<T>>;
+    using Result = std::pair<Dense, Dense>;
+
+    struct Candidate {
+        const char* name;
+        bool (*applicable)(const Dense&);
+        Result (*call)(const Dense&);
+    };
+
+    static constexpr const char* operation = "qr";
+
+    static const std::vector<Candidate>& candidates() {
+        static const std::vector<Candidate> list = {
+            {"Householder", always, nonNegativeDiagonal<Householder<T>>},
+            {"Givens", notTall, nonNegativeDiagonal<Givens<T>>},
+            {"GramSchmidt", square, nonNegativeDiagonal<GramSchmidt<T>>},
+        };
+        return list;
+    }
+
+    static int size(const Dense& A) {
+        return std::max(A.size(), A[0].size());
+    }
+
+    static std::tuple<Dense> sampleInput(int n, std::mt19937& rng) {
+        return {randomDense<T>(n, rng)};
+    }
+
+private:
+    static bool always(const Dense&) {
+        return true;
+    }
+
+    static bool notTall(const Dense& A) {
+        return A.size() <= A[0].size();
+    }
+
+    static bool square(const Dense& A) {
+        return A.size() == A[0].size();
+    }
+
+    // Flips the sign of row k of R and column k of Q wherever R[k][k] is negative
+    template<typename Policy>
+    static Result nonNegativeDiagonal(const Dense& A) {
+        auto [Q, R] = Policy::calculate(A);
+        int rank = std::min(Q[0].size(), R[0].size());
+        for (int k = 0; k < rank; ++k) {
+            if (R[k][k] < 0) {
+                for (T& value : R[k]) {
+                    value = -value;
+                }
+                for (auto& row : Q) {
+                    row[k] = -row[k];
+                }
+            }
+        }
+        return {Q, R};
+    }
+};
+
+template<typename T>
+struct CholeskyTuning {
+    using Dense = std::vector<std::vector<T>>;
+    using Result = Dense;
+
+    struct Candidate {
+        const char* name;
+        bool (*applicable)(const Dense&);
+        Result (*call)(const Dense&);
+    };
+
+    static constexpr const char* operation = "cholesky";
+
+    static const std::vector<Candidate>& candidates() {
+        static const std::vector<Candidate> list = {
+            {"Cholesky", always, Cholesky<T>::calculate},
+            {"RecursiveCholesky", always, RecursiveCholesky<T>::calculate},
+        };
+        return list;
+    }
+
+    static int size(const Dense& A) {
+        return A.size();
+    }
+
+    static std::tuple<Dense> sampleInput(int n, std::mt19937& rng) {
+        return {diagonallyDominantDense<T>(n, rng)};
+    }
+
+private:
+    static bool always(const Dense&) {
+        return true;
+    }
+};
+
+//====================DISPATCH====================================
+
+template<typename T, template<typename> class Tuning>
+class AutoTuned {
+public:
+    template<typename... Args>
+    static typename Tuning<T>::Result calculate(const Args&... args) {
+        // The candidates take dense rows; views and other row-indexable inputs are copied once
+        if constexpr (!(std::is_same_v<Args, std::vector<std::vector<T>>> && ...)) {
+            return calculate(denseRows<T>(args)...);
+        } else {
+            const auto& candidates = Tuning<T>::candidates();
+            for (int index : ranking(Tuning<T>::size(args...))) {
+                if (candidates[index].applicable(args...)) {
+                    return candidates[index].call(args...);
+                }
+            }
+            return candidates[0].call(args...);
+        }
+    }
+
+    // Ranks the candidates for every bucket up to `maxSize`; `force` re-times buckets
+    // that already have an entry in the tuning table.
+    static void calibrate(int maxSize, bool force = false) {
+        std::lock_guard<std::mutex> lock(mutex());
+        for (int bucket = 0; bucket <= autoTuneBucket(maxSize); ++bucket) {
+            resolve(bucket, force);
+        }
+    }
+
+    // Candidate chosen for an input of the given size (ignoring applicability)
+    static const char* selected(int size) {
+        return Tuning<T>::candidates()[ranking(size).front()].name;
+    }
+
+private:
+    // Each bucket publishes an immutable ranking. A forced recalibration publishes a new one
+    // instead of overwriting it, and the old ones stay alive for callers still iterating them.
+    struct Cache {
+        std::array<std::atomic<const std::vector<int>*>, MaxCalibrationBucket + 1> rankings{};
+        std::vector<std::unique_ptr<const std::vector<int>>> published;
+    };
+
+    static Cache& cache() {
+        static Cache instance;
+        return instance;
+    }
+
+    static std::mutex& mutex() {
+        static std::mutex instance;
+        return instance;
+    }
+
+    static const std::vector<int>& ranking(int size) {
+        int bucket = autoTuneBucket(size);
+        Cache& state = cache();
+        const std::vector<int>* order = state.rankings[bucket].load(std::memory_order_acquire);
+        if (order == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex());
+            for (int smaller = 0; smaller <= bucket; ++smaller) {
+                resolve(smaller, false);
+            }
+            order = state.rankings[bucket].load(std::memory_order_acquire);
+        }
+        return *order;
+    }
+
+    static std::string key(int bucket) {
+        std::string type(policyName<T>());
+        std::replace(type.begin(), type.end(), ' ', '_');
+        return type + " " + Tuning<T>::operation + " " + std::to_string(bucket);
+    }
+
+    // Fills the cache for `bucket` from the table, timing the candidates if the table has no entry.
+    // Buckets must be resolved in increasing order; the caller holds mutex().
+    static void resolve(int bucket, bool force) {
+        Cache& state = cache();
+        if (state.rankings[bucket].load(std::memory_order_relaxed) != nullptr && !force) {
+            return;
+        }
+
+        AutoTuneEntry entry;
+        if (force || !AutoTuneTable::instance().find(key(bucket), entry)) {
+            entry = measure(bucket);
+            AutoTuneTable::instance().store(key(bucket), entry);
+        }
+
+        const auto& candidates = Tuning<T>::candidates();
+        std::vector<int> order;
+        for (const auto& [name, time] : entry.ranking) {
+            for (int i = 0; i < static_cast<int>(candidates.size()); ++i) {
+                if (name == candidates[i].name && std::find(order.begin(), order.end(), i) == order.end()) {
+                    order.push_back(i);
+                }
+            }
+        }
+        // Candidates missing from an older table go last, in declaration order
+        for (int i = 0; i < static_cast<int>(candidates.size()); ++i) {
+            if (std::find(order.begin(), order.end(), i) == order.end()) {
+                order.push_back(i);
+            }
+        }
+        state.published.push_back(std::make_unique<const std::vector<int>>(std::move(order)));
+        state.rankings[bucket].store(state.published.back().get(), std::memory_order_release);
+    }
+
+    // A candidate that was timed at the previous bucket and came out more than PruneFactor
+    // times slower than its winner is skipped at this bucket, which keeps calibration of the
+    // large buckets affordable. Pruning is not sticky: a candidate skipped at the previous
+    // bucket has no measurement to judge it by and is timed again, so an asymptotically
+    // faster candidate still gets to overtake the winner as the sizes grow.
+    static constexpr double PruneFactor = 8;
+
+    static AutoTuneEntry measure(int bucket) {
+        using Clock = std::chrono::steady_clock;
+
+        int n = 1 << bucket;
+        std::mt19937 rng(12345 + bucket);
+        auto input = Tuning<T>::sampleInput(n, rng);
+
+        AutoTuneEntry previous;
+        bool hasPrevious = bucket > 0 && AutoTuneTable::instance().find(key(bucket - 1), previous) && !previous.ranking.empty();
+        double previousBest = hasPrevious ? previous.ranking.front().second : 0;
+
+        AutoTuneEntry entry;
+        std::vector<std::pair<std::string, double>> skipped;
+        for (const auto& candidate : Tuning<T>::candidates()) {
+            bool applicable = std::apply([&](const auto&... args) { return candidate.applicable(args...); }, input);
+            double previousTime = -1;
+            for (const auto& [name, time] : previous.ranking) {
+                if (name == candidate.name) previousTime = time;
+            }
+            if (!applicable || (hasPrevious && previousTime > PruneFactor * previousBest)) {
+                skipped.emplace_back(candidate.name, -1);
+                continue;
+            }
+
+            double best = 0;
+            auto start = Clock::now();
+            for (int repetition = 0; repetition < 5; ++repetition) {
+                auto begin = Clock::now();
+                auto result = std::apply([&](const auto&... args) { return candidate.call(args...); }, input);
+                auto end = Clock::now();
+                double elapsed = std::chrono::duration<double, std::nano>(end - begin).count();
+                best = repetition == 0 ? elapsed : std::min(best, elapsed);
+                if (std::chrono::duration<double>(end - start).count() > 0.05) {
+                    break;
+                }
+            }
+            entry.ranking.emplace_back(candidate.name, best);
+        }
+
+        std::stable_sort(entry.ranking.begin(), entry.ranking.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+        entry.ranking.insert(entry.ranking.end(), skipped.begin(), skipped.end());
+        return entry;
+    }
+};
+
+template<typename T>
+using AutoTunedMultiplication = AutoTuned<T, MultiplicationTuning>;
+
+template<typename T>
+using AutoTunedLU = AutoTuned<T, LUTuning>;
+
+template<typename T>
+using AutoTunedQR = AutoTuned<T, QRTuning>;
+
+template<typename T>
+using AutoTunedCholesky = AutoTuned<T, CholeskyTuning>;
+
+template<typename T>
+struct AutoTunedPolicies : MatrixPolicies<T> {
+    using MultiplicationPolicy = AutoTunedMultiplication<T>;
+    using LUPolicy = AutoTunedLU<T>;
+    using QRPolicy = AutoTunedQR<T>;
+    using CholeskyPolicy = AutoTunedCholesky<T>;
+};
+
+// Fills the tuning table for all tuned operations up to `maxSize` (at most 2^MaxCalibrationBucket is timed)
+template<typename T>
+void calibrateAutoTuning(int maxSize = 1 << MaxCalibrationBucket, bool force = false) {
+    AutoTunedMultiplication<T>::calibrate(maxSize, force);
+    AutoTunedLU<T>::calibrate(maxSize, force);
+    AutoTunedQR<T>::calibrate(maxSize, force);
+    AutoTunedCholesky<T>::calibrate(maxSize, force);
+}
+
+#endif // AUTO_TUNING_HPP
@@ -0,0 +1,714 @@
+#ifndef BANDED_MATRIX_HPP
+#define BANDED_MATRIX_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Concepts.hpp"
+#include "Executor.hpp"
+
+#ifndef MATRIX_HAS_SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MATRIX_HAS_SSE2 1
+#else
+#define MATRIX_HAS_SSE2 0
+#endif
+#endif
+
+// Square matrices whose nonzeros lie within a band around the diagonal, stored and solved in
+// O(n * bandwidth) memory and O(n * bandwidth^2) time instead of O(n^2) and O(n^3).
+
+// A general band with `lower` subdiagonals and `upper` superdiagonals. Row i keeps the
+// entries of columns i - lower ... i + upper contiguously, the row-oriented form of LAPACK's
+// band storage.
+template<typename T>
+class BandedMatrix {
+public:
+    BandedMatrix(int n, int lower, int upper)
+        : n(n), kl(lower), ku(upper), elements(elementCount(n, lower, upper), T(0)) {}
+
+    // The band of a square matrix whose entries outside it are all zero
+    template<RowIndexable<T> Rows>
+    static BandedMatrix fromRows(const Rows& matrix, int lower, int upper) {
+        int n = matrix.size();
+        BandedMatrix result(n, lower, upper);
+        for (int i = 0; i < n; ++i) {
+            if (static_cast<int>(matrix[i].size()) != n) {
+                throw std::invalid_argument("A banded matrix must be square.");
+            }
+            for (int j = 0; j < n; ++j) {
+                if (result.inBand(i, j)) {
+                    result.at(i, j) = matrix[i][j];
+                } else if (matrix[i][j] != T(0)) {
+                    throw std::invalid_argument("Matrix has nonzero entries outside the band.");
+                }
+            }
+        }
+        return result;
+    }
+
+    int size() const {
+        return n;
+    }
+
+    int lowerBandwidth() const {
+        return kl;
+    }
+
+    int upperBandwidth() const {
+        return ku;
+    }
+
+    bool inBand(int i, int j) const {
+        return i >= 0 && j >= 0 && i < n && j < n && j - i <= ku && i - j <= kl;
+    }
+
+    // Zero outside the band
+    T operator()(int i, int j) const {
+        return inBand(i, j) ? elements[index(i, j)] : T(0);
+    }
+
+    T& at(int i, int j) {
+        if (!inBand(i, j)) {
+            throw std::out_of_range("Element lies outside the band.");
+        }
+        return elements[index(i, j)];
+    }
+
+    std::vector<T> multiply(const std::vector<T>& x) const {
+        if (static_cast<int>(x.size()) != n) {
+            throw std::invalid_argument("Vector length does not match the matrix size.");
+        }
+        std::vector<T> result(n, T(0));
+        for (int i = 0; i < n; ++i) {
+            T sum = 0;
+            for (int j = std::max(0, i - kl); j <= std::min(n - 1, i + ku); ++j) {
+                sum += elements[index(i, j)] * x[j];
+            }
+            result[i] = sum;
+        }
+        return result;
+    }
+
+    std::vector<std::vector<T>> toVectorMatrix() const {
+        std::vector<std::vector<T>> result(n, std::vector<T>(n, T(0)));
+        for (int i = 0; i < n; ++i) {
+            for (int j = std::max(0, i - kl); j <= std::min(n - 1, i + ku); ++j) {
+                result[i][j] = elements[index(i, j)];
+            }
+        }
+        return result;
+    }
+
+private:
+    // Validates before the storage is sized from the bandwidths
+    static std::size_t elementCount(int n, int lower, int upper) {
+        if (n < 0 || lower < 0 || upper < 0) {
+            throw std::invalid_argument("Matrix size and bandwidths must not be negative.");
+        }
+        return static_cast<std::size_t>(n) * (static_cast<std::size_t>(lower) + upper + 1);
+    }
+
+    std::size_t index(int i, int j) const {
+        return static_cast<std::size_t>(i) * (kl + ku + 1) + (j - i + kl);
+    }
+
+    int n;
+    int kl;
+    int ku;
+    std::vector<T> elements;
+};
+
+// The three diagonals of a tridiagonal matrix: lower[i] is entry (i + 1, i), upper[i] is
+// entry (i, i + 1)
+template<typename T>
+class TridiagonalMatrix {
+public:
+    explicit TridiagonalMatrix(int n) : TridiagonalMatrix(std::vector<T>(std::max(n - 1, 0)), std::vector<T>(std::max(n, 0)), std::vector<T>(std::max(n - 1, 0))) {}
+
+    TridiagonalMatrix(std::vector<T> lower, std::vector<T> diagonal, std::vector<T> upper)
+        : sub(std::move(lower)), main(std::move(diagonal)), super(std::move(upper)) {
+        std::size_t offDiagonal = main.empty() ? 0 : main.size() - 1;
+        if (sub.size() != offDiagonal || super.size() != offDiagonal) {
+            throw std::invalid_argument("Off-diagonals of a tridiagonal matrix need one element fewer than the diagonal.");
+        }
+    }
+
+    int size() const {
+        return main.size();
+    }
+
+    std::vector<T>& lower() {
+        return sub;
+    }
+
+    const std::vector<T>& lower() const {
+        return sub;
+    }
+
+    std::vector<T>& diagonal() {
+        return main;
+    }
+
+    const std::vector<T>& diagonal() const {
+        return main;
+    }
+
+    std::vector<T>& upper() {
+        return super;
+    }
+
+    const std::vector<T>& upper() const {
+        return super;
+    }
+
+    T operator()(int i, int j) const {
+        if (i == j) {
+            return main[i];
+        } else if (i == j + 1) {
+            return sub[j];
+        } else if (j == i + 1) {
+            return super[i];
+        }
+        return T(0);
+    }
+
+    std::vector<T> multiply(const std::vector<T>& x) const {
+        int n = size();
+        if (static_cast<int>(x.size()) != n) {
+            throw std::invalid_argument("Vector length does not match the matrix size.");
+        }
+        std::vector<T> result(n);
+        for (int i = 0; i < n; ++i) {
+            T sum = main[i] * x[i];
+            if (i > 0) {
+                sum += sub[i - 1] * x[i - 1];
+            }
+            if (i + 1 < n) {
+                sum += super[i] * x[i + 1];
+            }
+            result[i] = sum;
+        }
+        return result;
+    }
+
+    BandedMatrix<T> toBanded() const {
+        int n = size();
+        BandedMatrix<T> result(n, 1, 1);
+        for (int i = 0; i < n; ++i) {
+            result.at(i, i) = main[i];
+            if (i + 1 < n) {
+                result.at(i + 1, i) = sub[i];
+                result.at(i, i + 1) = super[i];
+            }
+        }
+        return result;
+    }
+
+    std::vector<std::vector<T>> toVectorMatrix() const {
+        return toBanded().toVectorMatrix();
+    }
+
+private:
+    std::vector<T> sub;
+    std::vector<T> main;
+    std::vector<T> super;
+};
+
+// Independent tridiagonal systems of one size, interleaved so that row i of system s sits at
+// i * count + s: the same step of every system is a contiguous run that the batched solver
+// processes in SIMD lanes
+template<typename T>
+class TridiagonalBatch {
+public:
+    TridiagonalBatch(int n, int count)
+        : n(n), systems(count), sub(elementCount(n, count), T(0)), main(sub.size(), T(0)), super(sub.size(), T(0)) {}
+
+    int size() const {
+        return n;
+    }
+
+    int count() const {
+        return systems;
+    }
+
+    // Entry (i, i - 1) of a system; unused for i = 0
+    T& lower(int i, int system) {
+        return sub[static_cast<std::size_t>(i) * systems + system];
+    }
+
+    T& diagonal(int i, int system) {
+        return main[static_cast<std::size_t>(i) * systems + system];
+    }
+
+    // Entry (i, i + 1) of a system; unused for i = n - 1
+    T& upper(int i, int system) {
+        return super[static_cast<std::size_t>(i) * systems + system];
+    }
+
+    void set(int system, const TridiagonalMatrix<T>& matrix) {
+        if (matrix.size() != n) {
+            throw std::invalid_argument("System size does not match the batch.");
+        }
+        for (int i = 0; i < n; ++i) {
+            diagonal(i, system) = matrix.diagonal()[i];
+            lower(i, system) = i > 0 ? matrix.lower()[i - 1] : T(0);
+            upper(i, system) = i + 1 < n ? matrix.upper()[i] : T(0);
+        }
+    }
+
+    const T* lowerData() const {
+        return sub.data();
+    }
+
+    const T* diagonalData() const {
+        return main.data();
+    }
+
+    const T* upperData() const {
+        return super.data();
+    }
+
+private:
+    static std::size_t elementCount(int n, int count) {
+        if (n < 0 || count < 0) {
+            throw std::invalid_argument("Batch size and count must not be negative.");
+        }
+        return static_cast<std::size_t>(n) * count;
+    }
+
+    int n;
+    int systems;
+    std::vector<T> sub;
+    std::vector<T> main;
+    std::vector<T> super;
+};
+
+// The Thomas algorithm: tridiagonal Gaussian elimination without pivoting in O(n). Stable for
+// diagonally dominant or symmetric positive definite matrices; use BandedLU otherwise.
+template<typename T>
+class ThomasSolver {
+public:
+    static std::vector<T> solve(const TridiagonalMatrix<T>& A, const std::vector<T>& b) {
+        int n = A.size();
+        if (static_cast<int>(b.size()) != n) {
+            throw std::invalid_argument("Vector length does not match the matrix size.");
+        }
+        const std::vector<T>& lower = A.lower();
+        const std::vector<T>& diagonal = A.diagonal();
+        const std::vector<T>& upper = A.upper();
+        std::vector<T> c(n);
+        std::vector<T> x(b);
+        for (int i = 0; i < n; ++i) {
+            T pivot = diagonal[i];
+            if (i > 0) {
+                pivot -= lower[i - 1] * c[i - 1];
+                x[i] -= lower[i - 1] * x[i - 1];
+            }
+            if (pivot == T(0)) {
+                throw std::runtime_error("Zero pivot encountered in Thomas algorithm.");
+            }
+            T inverse = T(1) / pivot;
+            c[i] = i + 1 < n ? upper[i] * inverse : T(0);
+            x[i] *= inverse;
+        }
+        for (int i = n - 2; i >= 0; --i) {
+            x[i] -= c[i] * x[i + 1];
+        }
+        return x;
+    }
+};
+
+#if MATRIX_HAS_SSE2
+// The SSE2 operations the batched solver needs, for float (4 lanes) and double (2 lanes)
+template<typename T>
+struct SseLanes;
+
+template<>
+struct SseLanes<double> {
+    static constexpr int Width = 2;
+
+    static __m128d load(const double* p) {
+        return _mm_loadu_pd(p);
+    }
+
+    static void store(double* p, __m128d v) {
+        _mm_storeu_pd(p, v);
+    }
+
+    static __m128d one() {
+        return _mm_set1_pd(1.0);
+    }
+
+    static __m128d sub(__m128d a, __m128d b) {
+        return _mm_sub_pd(a, b);
+    }
+
+    static __m128d mul(__m128d a, __m128d b) {
+        return _mm_mul_pd(a, b);
+    }
+
+    static __m128d div(__m128d a, __m128d b) {
+        return _mm_div_pd(a, b);
+    }
+
+    static int zeroMask(__m128d v) {
+        return _mm_movemask_pd(_mm_cmpeq_pd(v, _mm_setzero_pd()));
+    }
+};
+
+template<>
+struct SseLanes<float> {
+    static constexpr int Width = 4;
+
+    static __m128 load(const float* p) {
+        return _mm_loadu_ps(p);
+    }
+
+    static void store(float* p, __m128 v) {
+        _mm_storeu_ps(p, v);
+    }
+
+    static __m128 one() {
+        return _mm_set1_ps(1.0f);
+    }
+
+    static __m128 sub(__m128 a, __m128 b) {
+        return _mm_sub_ps(a, b);
+    }
+
+    static __m128 mul(__m128 a, __m128 b) {
+        return _mm_mul_ps(a, b);
+    }
+
+    static __m128 div(__m128 a, __m128 b) {
+        return _mm_div_ps(a, b);
+    }
+
+    static int zeroMask(__m128 v) {
+        return _mm_movemask_ps(_mm_cmpeq_ps(v, _mm_setzero_ps()));
+    }
+};
+#endif
+
+// The Thomas algorithm over a TridiagonalBatch. The loops run across systems, so each step
+// is a vectorizable pass over contiguous lanes; blocks of lanes go to the executor when the
+// batch is large. Right-hand sides and solutions use the batch's interleaved layout.
+template<typename T>
+class BatchedThomasSolver {
+public:
+    // Systems per block, so a block's working set stays in cache while it is swept
+    static constexpr int LaneBlock = 256;
+    // Below this many rows in total the batch is not worth handing to other threads
+    static constexpr std::size_t ParallelElements = std::size_t(1) << 18;
+
+    static std::vector<T> solve(const TridiagonalBatch<T>& systems, std::vector<T> rhs) {
+        int n = systems.size();
+        int count = systems.count();
+        if (rhs.size() != static_cast<std::size_t>(n) * count) {
+            throw std::invalid_argument("Right-hand sides do not match the batch.");
+        }
+        int blocks = (count + LaneBlock - 1) / LaneBlock;
+        std::atomic<bool> singular{false};
+        auto solveBlock = [&](int block) {
+            int first = block * LaneBlock;
+            int lanes = std::min(LaneBlock, count - first);
+            if (!sweep(systems, rhs.data(), first, lanes)) {
+                singular = true;
+            }
+        };
+        if (static_cast<std::size_t>(n) * count >= ParallelElements) {
+            MatrixExecutor::current().parallelFor(blocks, solveBlock);
+        } else {
+            for (int block = 0; block < blocks; ++block) {
+                solveBlock(block);
+            }
+        }
+        if (singular) {
+            throw std::runtime_error("Zero pivot encountered in Thomas algorithm.");
+        }
+        return rhs;
+    }
+
+private:
+    // Solves systems first ... first + lanes - 1 in place; false on a zero pivot
+    static bool sweep(const TridiagonalBatch<T>& systems, T* x, int first, int lanes) {
+        int n = systems.size();
+        std::size_t stride = systems.count();
+        const T* lower = systems.lowerData() + first;
+        const T* diagonal = systems.diagonalData() + first;
+        const T* upper = systems.upperData() + first;
+        x += first;
+        std::vector<T> c(static_cast<std::size_t>(n) * lanes);
+        // Row 0 has no previous row; zeros stand in for it
+        std::vector<T> none(lanes, T(0));
+        bool zeroPivot = false;
+        for (int i = 0; i < n; ++i) {
+            T* ci = c.data() + static_cast<std::size_t>(i) * lanes;
+            T* xi = x + i * stride;
+            const T* previousC = i > 0 ? ci - lanes : none.data();
+            const T* previousX = i > 0 ? xi - stride : none.data();
+            zeroPivot |= forward(lower + i * stride, diagonal + i * stride, upper + i * stride, previousC, previousX, ci, xi, lanes);
+        }
+        for (int i = n - 2; i >= 0; --i) {
+            backward(c.data() + static_cast<std::size_t>(i) * lanes, x + (i + 1) * stride, x + i * stride, lanes);
+        }
+        return !zeroPivot;
+    }
+
+    // One elimination step in every lane: pivot = d - a * previousC, c = u / pivot and
+    // x = (x - a * previousX) / pivot. Returns whether some pivot was zero.
+    static bool forward(const T* a, const T* d, const T* u, const T* previousC, const T* previousX, T* c, T* x, int lanes) {
+        int s = 0;
+        int zeroLanes = 0;
+#if MATRIX_HAS_SSE2
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+            using L = SseLanes<T>;
+            for (; s + L::Width <= lanes; s += L::Width) {
+                auto av = L::load(a + s);
+                auto pivot = L::sub(L::load(d + s), L::mul(av, L::load(previousC + s)));
+                zeroLanes |= L::zeroMask(pivot);
+                auto inverse = L::div(L::one(), pivot);
+                L::store(c + s, L::mul(L::load(u + s), inverse));
+                L::store(x + s, L::mul(L::sub(L::load(x + s), L::mul(av, L::load(previousX + s))), inverse));
+            }
+        }
+#endif
+        for (; s < lanes; ++s) {
+            T pivot = d[s] - a[s] * previousC[s];
+            zeroLanes |= pivot == T(0);
+            T inverse = T(1) / pivot;
+            c[s] = u[s] * inverse;
+            x[s] = (x[s] - a[s] * previousX[s]) * inverse;
+        }
+        return zeroLanes != 0;
+    }
+
+    // x -= c * nextX in every lane
+    static void backward(const T* c, const T* nextX, T* x, int lanes) {
+        int s = 0;
+#if MATRIX_HAS_SSE2
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+            using L = SseLanes<T>;
+            for (; s + L::Width <= lanes; s += L::Width) {
+                L::store(x + s, L::sub(L::load(x + s), L::mul(L::load(c + s), L::load(nextX + s))));
+            }
+        }
+#endif
+        for (; s < lanes; ++s) {
+            x[s] -= c[s] * nextX[s];
+        }
+    }
+};
+
+// LU with partial pivoting restricted to the band (LAPACK's gbtrf): a pivot comes from the
+// `lower` rows below the diagonal, so U gains at most `lower` extra superdiagonals and the
+// factorization costs O(n * lower * (lower + upper)). The factors solve any number of
+// right-hand sides in O(n * (2 * lower + upper)) each.
+template<typename T>
+class BandedLU {
+public:
+    class Factorization {
+    public:
+        std::vector<T> solve(std::vector<T> b) const {
+            if (static_cast<int>(b.size()) != n) {
+                throw std::invalid_argument("Vector length does not match the matrix size.");
+            }
+            for (int k = 0; k < n; ++k) {
+                std::swap(b[k], b[pivots[k]]);
+                for (int i = k + 1; i <= std::min(n - 1, k + kl); ++i) {
+                    b[i] -= multipliers[static_cast<std::size_t>(k) * kl + (i - k - 1)] * b[k];
+                }
+            }
+            for (int i = n - 1; i >= 0; --i) {
+                T sum = b[i];
+                for (int j = i + 1; j <= std::min(n - 1, i + kl + ku); ++j) {
+                    sum -= u(i, j) * b[j];
+                }
+                b[i] = sum / u(i, i);
+            }
+            return b;
+        }
+
+        int size() const {
+            return n;
+        }
+
+    private:
+        friend class BandedLU;
+
+        Factorization(int n, int lower, int upper)
+            : n(n), kl(lower), ku(upper), width(2 * lower + upper + 1),
+              elements(static_cast<std::size_t>(n) * width, T(0)), multipliers(static_cast<std::size_t>(n) * lower, T(0)), pivots(n) {}
+
+        // Row i holds columns i - kl ... i + kl + ku, room for the fill-in that pivoting adds
+        T& u(int i, int j) {
+            return elements[static_cast<std::size_t>(i) * width + (j - i + kl)];
+        }
+
+        const T& u(int i, int j) const {
+            return elements[static_cast<std::size_t>(i) * width + (j - i + kl)];
+        }
+
+        int n;
+        int kl;
+        int ku;
+        int width;
+        std::vector<T> elements;
+        std::vector<T> multipliers;
+        std::vector<int> pivots;
+    };
+
+    static Factorization factor(const BandedMatrix<T>& A) {
+        int n = A.size();
+        int kl = A.lowerBandwidth();
+        int ku = A.upperBandwidth();
+        Factorization f(n, kl, ku);
+        for (int i = 0; i < n; ++i) {
+            for (int j = std::max(0, i - kl); j <= std::min(n - 1, i + ku); ++j) {
+                f.u(i, j) = A(i, j);
+            }
+        }
+
+        for (int k = 0; k < n; ++k) {
+            int last = std::min(n - 1, k + kl);
+            int right = std::min(n - 1, k + kl + ku);
+            int pivot = k;
+            for (int i = k + 1; i <= last; ++i) {
+                if (std::abs(f.u(i, k)) > std::abs(f.u(pivot, k))) {
+                    pivot = i;
+                }
+            }
+            if (f.u(pivot, k) == T(0)) {
+                throw std::runtime_error("Singular matrix encountered during banded LU decomposition.");
+            }
+            f.pivots[k] = pivot;
+            if (pivot != k) {
+                for (int j = k; j <= right; ++j) {
+                    std::swap(f.u(k, j), f.u(pivot, j));
+                }
+            }
+            for (int i = k + 1; i <= last; ++i) {
+                T factor = f.u(i, k) / f.u(k, k);
+                f.multipliers[static_cast<std::size_t>(k) * kl + (i - k - 1)] = factor;
+                f.u(i, k) = T(0);
+                if (factor != T(0)) {
+                    for (int j = k + 1; j <= right; ++j) {
+                        f.u(i, j) -= factor * f.u(k, j);
+                    }
+                }
+            }
+        }
+        return f;
+    }
+
+    static std::vector<T> solve(const BandedMatrix<T>& A, const std::vector<T>& b) {
+        return factor(A).solve(b);
+    }
+
+    static std::vector<T> solve(const TridiagonalMatrix<T>& A, const std::vector<T>& b) {
+        return factor(A.toBanded()).solve(b);
+    }
+};
+
+// Cholesky of a symmetric positive definite band matrix from its lower band: L keeps the
+// bandwidth of A, so the factorization costs O(n * bandwidth^2) and each solve O(n * bandwidth)
+template<typename T>
+class BandedCholesky {
+public:
+    class Factorization {
+    public:
+        std::vector<T> solve(std::vector<T> b) const {
+            if (static_cast<int>(b.size()) != n) {
+                throw std::invalid_argument("Vector length does not match the matrix size.");
+            }
+            for (int i = 0; i < n; ++i) {
+                T sum = b[i];
+                for (int k = std::max(0, i - kl); k < i; ++k) {
+                    sum -= l(i, k) * b[k];
+                }
+                b[i] = sum / l(i, i);
+            }
+            for (int i = n - 1; i >= 0; --i) {
+                T sum = b[i];
+                for (int k = i + 1; k <= std::min(n - 1, i + kl); ++k) {
+                    sum -= l(k, i) * b[k];
+                }
+                b[i] = sum / l(i, i);
+            }
+            return b;
+        }
+
+        // L as a band matrix with no superdiagonals
+        BandedMatrix<T> lower() const {
+            BandedMatrix<T> result(n, kl, 0);
+            for (int i = 0; i < n; ++i) {
+                for (int j = std::max(0, i - kl); j <= i; ++j) {
+                    result.at(i, j) = l(i, j);
+                }
+            }
+            return result;
+        }
+
+        int size() const {
+            return n;
+        }
+
+    private:
+        friend class BandedCholesky;
+
+        Factorization(int n, int bandwidth) : n(n), kl(bandwidth), elements(static_cast<std::size_t>(n) * (bandwidth + 1), T(0)) {}
+
+        T& l(int i, int j) {
+            return elements[static_cast<std::size_t>(i) * (kl + 1) + (j - i + kl)];
+        }
+
+        const T& l(int i, int j) const {
+            return elements[static_cast<std::size_t>(i) * (kl + 1) + (j - i + kl)];
+        }
+
+        int n;
+        int kl;
+        std::vector<T> elements;
+    };
+
+    static Factorization factor(const BandedMatrix<T>& A) {
+        int n = A.size();
+        int kl = A.lowerBandwidth();
+        if (A.upperBandwidth() != kl) {
+            throw std::invalid_argument("Banded Cholesky needs equal lower and upper bandwidths.");
+        }
+        Factorization f(n, kl);
+        for (int i = 0; i < n; ++i) {
+            int first = std::max(0, i - kl);
+            for (int j = first; j <= i; ++j) {
+                T sum = A(i, j);
+                for (int k = first; k < j; ++k) {
+                    sum -= f.l(i, k) * f.l(j, k);
+                }
+                if (i == j) {
+                    if (sum <= 0) {
+                        throw std::runtime_error("Matrix is not positive definite.");
+                    }
+                    f.l(i, i) = std::sqrt(sum);
+                } else {
+                    f.l(i, j) = sum / f.l(j, j);
+                }
+            }
+        }
+        return f;
+    }
+
+    static std::vector<T> solve(const BandedMatrix<T>& A, const std::vector<T>& b) {
+        return factor(A).solve(b);
+    }
+};
+
+#endif // BANDED_MATRIX_HPP
@@ -1,10 +1,19 @@
 #ifndef CHOLESKY_POLICIES_HPP
 #define CHOLESKY_POLICIES_HPP
 
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Concepts.hpp"
+#include "TaskGraph.hpp"
+
 template<typename T>
 class Cholesky {
 public:
-    static std::vector<std::vector<T>> calculate(const std::vector<std::vector<T>>& matrix) {
+    template<RowIndexable<T> Rows>
+    static std::vector<std::vector<T>> calculate(const Rows& matrix) {
         int N = matrix.size();
         std::vector<std::vector<T>> L(N, std::vector<T>(N, 0));
 
@@ -32,7 +41,8 @@ public:
 template<typename T>
 class RecursiveCholesky {
 public:
-    static std::vector<std::vector<T>> calculate(const std::vector<std::vector<T>>& matrix) {
+    template<RowIndexable<T> Rows>
+    static std::vector<std::vector<T>> calculate(const Rows& matrix) {
         int N = matrix.size();
         std::vector<std::vector<T>> L(N, std::vector<T>(N, 0));
         decompose(matrix, L, 0, N);
@@ -40,7 +50,8 @@ public:
     }
 
 private:
-    static void decompose(const std::vector<std::vector<T>>& A, std::vector<std::vector<T>>& L, int start, int N) {
+    template<typename Rows>
+    static void decompose(const Rows& A, std::vector<std::vector<T>>& L, int start, int N) {
         if (N <= 1) {
             L[start][start] = std::sqrt(A[start][start]);
             return;
@@ -79,4 +90,194 @@ private:
 
 
 
+// Right-looking Cholesky over TileSize x TileSize tiles, expressed as a TaskGraph: factor the
+// diagonal tile (potrf), solve the tiles below it (trsm), then update the trailing matrix
+// (syrk on diagonal tiles, gemm elsewhere). Updates for step k + 1 start as soon as the
+// tiles they need are final, without waiting for the rest of step k. The tile size is clamped
+// to the matrix size and the kernels only touch the part of an edge tile inside the matrix.
+template<typename T, int TileSize = 128>
+class TiledCholesky {
+public:
+    template<RowIndexable<T> Rows>
+    static std::vector<std::vector<T>> calculate(const Rows& matrix) {
+        int n = matrix.size();
+        TileGrid<T> A(matrix, std::min(TileSize, std::max(n, 1)));
+        int tiles = A.tileRows();
+        int ld = A.tileSize();
+        TaskGraph graph;
+
+        for (int k = 0; k < tiles; ++k) {
+            T* Akk = A.tile(k, k);
+            int nk = A.tileHeight(k);
+            graph.add([=] { potrf(Akk, ld, nk); }, {TaskGraph::writes(Akk)});
+            for (int m = k + 1; m < tiles; ++m) {
+                T* Amk = A.tile(m, k);
+                int nm = A.tileHeight(m);
+                graph.add([=] { trsm(Akk, Amk, ld, nm, nk); }, {TaskGraph::reads(Akk), TaskGraph::writes(Amk)});
+            }
+            for (int j = k + 1; j < tiles; ++j) {
+                T* Ajk = A.tile(j, k);
+                T* Ajj = A.tile(j, j);
+                int nj = A.tileHeight(j);
+                graph.add([=] { syrk(Ajk, Ajj, ld, nj, nk); }, {TaskGraph::reads(Ajk), TaskGraph::writes(Ajj)});
+                for (int m = j + 1; m < tiles; ++m) {
+                    T* Amk = A.tile(m, k);
+                    T* Amj = A.tile(m, j);
+                    int nm = A.tileHeight(m);
+                    graph.add([=] { gemm(Amk, Ajk, Amj, ld, nm, nj, nk); }, {TaskGraph::reads(Amk), TaskGraph::reads(Ajk), TaskGraph::writes(Amj)});
+                }
+            }
+        }
+        graph.run();
+
+        std::vector<std::vector<T>> L = A.toVectorMatrix();
+        for (int i = 0; i < static_cast<int>(L.size()); ++i) {
+            std::fill(L[i].begin() + i + 1, L[i].end(), T(0));
+        }
+        return L;
+    }
+
+private:
+    // The kernels work on tiles with row stride ld; the sizes are the extents inside the matrix
+
+    // A = L * L^T in place for the n x n tile A, lower triangle
+    static void potrf(T* A, int ld, int n) {
+        for (int j = 0; j < n; ++j) {
+            T diagonal = A[j * ld + j];
+            for (int k = 0; k < j; ++k) {
+                diagonal -= A[j * ld + k] * A[j * ld + k];
+            }
+            if (!(diagonal > 0)) {
+                throw std::runtime_error("Matrix is not positive definite.");
+            }
+            diagonal = std::sqrt(diagonal);
+            A[j * ld + j] = diagonal;
+            for (int i = j + 1; i < n; ++i) {
+                T sum = A[i * ld + j];
+                for (int k = 0; k < j; ++k) {
+                    sum -= A[i * ld + k] * A[j * ld + k];
+                }
+                A[i * ld + j] = sum / diagonal;
+            }
+        }
+    }
+
+    // A = A * L^-T for the m x n tile A and the n x n factor L
+    static void trsm(const T* L, T* A, int ld, int m, int n) {
+        for (int i = 0; i < m; ++i) {
+            T* row = A + i * ld;
+            for (int j = 0; j < n; ++j) {
+                T sum = row[j];
+                for (int k = 0; k < j; ++k) {
+                    sum -= row[k] * L[j * ld + k];
+                }
+                row[j] = sum / L[j * ld + j];
+            }
+        }
+    }
+
+    // C -= A * A^T for the n x k tile A, lower triangle of the n x n tile C
+    static void syrk(const T* A, T* C, int ld, int n, int k) {
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j <= i; ++j) {
+                T sum = 0;
+                for (int p = 0; p < k; ++p) {
+                    sum += A[i * ld + p] * A[j * ld + p];
+                }
+                C[i * ld + j] -= sum;
+            }
+        }
+    }
+
+    // C -= A * B^T for the m x k tile A, n x k tile B and m x n tile C
+    static void gemm(const T* A, const T* Bt, T* C, int ld, int m, int n, int k) {
+        for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < n; ++j) {
+                T sum = 0;
+                for (int p = 0; p < k; ++p) {
+                    sum += A[i * ld + p] * Bt[j * ld + p];
+                }
+                C[i * ld + j] -= sum;
+            }
+        }
+    }
+};
+
+// Rank-one modifications of a Cholesky factor in O(n^2) instead of refactorizing in O(n^3):
+// afterwards L L^T equals the old L L^T plus (update) or minus (downdate) x x^T. These are
+// LINPACK's dchud and dchdd applied to R = L^T, so the rotations walk the rows of L.
+template<typename T>
+class CholeskyUpdate {
+public:
+    // Givens rotations that fold x into L row by row
+    static void update(std::vector<std::vector<T>>& L, const std::vector<T>& x) {
+        int n = L.size();
+        checkSize(n, x);
+        std::vector<T> c(n), s(n);
+        for (int j = 0; j < n; ++j) {
+            std::vector<T>& row = L[j];
+            T xj = x[j];
+            for (int i = 0; i < j; ++i) {
+                T t = c[i] * row[i] + s[i] * xj;
+                xj = c[i] * xj - s[i] * row[i];
+                row[i] = t;
+            }
+            T r = std::sqrt(row[j] * row[j] + xj * xj);
+            c[j] = row[j] / r;
+            s[j] = xj / r;
+            row[j] = r;
+        }
+    }
+
+    // Solves L a = x first: the downdated matrix is positive definite exactly when |a| < 1, so L
+    // is checked before it is modified and is left unchanged if the downdate is impossible.
+    // The rotations are then ordinary Givens rotations built from a, which is more stable
+    // than applying hyperbolic rotations directly.
+    static void downdate(std::vector<std::vector<T>>& L, const std::vector<T>& x) {
+        int n = L.size();
+        checkSize(n, x);
+        std::vector<T> a(n);
+        T norm = 0;
+        for (int i = 0; i < n; ++i) {
+            T sum = x[i];
+            for (int k = 0; k < i; ++k) {
+                sum -= L[i][k] * a[k];
+            }
+            a[i] = sum / L[i][i];
+            norm += a[i] * a[i];
+        }
+        if (!(norm < T(1))) {
+            throw std::runtime_error("Downdate would leave a matrix that is not positive definite.");
+        }
+
+        std::vector<T> c(n), s(n);
+        T alpha = std::sqrt(T(1) - norm);
+        for (int i = n - 1; i >= 0; --i) {
+            T scale = alpha + std::abs(a[i]);
+            T p = alpha / scale;
+            T q = a[i] / scale;
+            T r = std::sqrt(p * p + q * q);
+            c[i] = p / r;
+            s[i] = q / r;
+            alpha = scale * r;
+        }
+        for (int j = 0; j < n; ++j) {
+            std::vector<T>& row = L[j];
+            T carry = 0;
+            for (int i = j; i >= 0; --i) {
+                T t = c[i] * carry + s[i] * row[i];
+                row[i] = c[i] * row[i] - s[i] * carry;
+                carry = t;
+            }
+        }
+    }
+
+private:
+    static void checkSize(int n, const std::vector<T>& x) {
+        if (static_cast<int>(x.size()) != n) {
+            throw std::invalid_argument("Vector length does not match the factor size.");
+        }
+    }
+};
+
 #endif // Cholesky_POLICIES_HPP
@@ -2,6 +2,8 @@
 #define CONCEPTS_HPP
 
 #include <concepts>
+#include <cstddef>
+#include <iosfwd>
 
 template<typename T>
 concept Negatable = requires(T a) {
@@ -31,6 +33,19 @@ concept Arithmetic = requires(T a, T b) {
     { a / b } -> std::convertible_to<T>;
 };
 
+// Integers with exact division and a remainder, e.g. int, long long or a big-integer class
+template<typename T>
+concept ExactInteger = !std::floating_point<T> && requires(T a, T b) {
+    { a + b } -> std::convertible_to<T>;
+    { a - b } -> std::convertible_to<T>;
+    { a * b } -> std::convertible_to<T>;
+    { a / b } -> std::convertible_to<T>;
+    { a % b } -> std::convertible_to<T>;
+    { -a } -> std::convertible_to<T>;
+    { a < b } -> std::convertible_to<bool>;
+    { a == b } -> std::convertible_to<bool>;
+};
+
 template<int M, int N, typename T>
 concept SquareMatrix = (M == N);
 
@@ -41,4 +56,13 @@ concept ComparableWithTolerance = requires(T a, T b, T tolerance) {
     { tolerance >= 0 } -> std::convertible_to<bool>;
 };
 
+// Anything read as matrix[i][j] with matrix.size() rows and matrix[i].size() columns,
+// e.g. std::vector<std::vector<T>> or ConstMatrixView<T>
+template<typename Rows, typename T>
+concept RowIndexable = requires(const Rows& matrix, std::size_t i) {
+    { matrix.size() } -> std::convertible_to<std::size_t>;
+    { matrix[i].size() } -> std::convertible_to<std::size_t>;
+    { matrix[i][i] } -> std::convertible_to<T>;
+};
+
 #endif // CONCEPTS_HPP
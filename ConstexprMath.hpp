@@ -0,0 +1,69 @@
+#ifndef CONSTEXPR_MATH_HPP
+#define CONSTEXPR_MATH_HPP
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+// std::sqrt and std::abs are not usable in constant expressions. These fall back to
+// the library functions at run time and only use the hand-written versions during
+// constant evaluation.
+class ConstexprMath {
+public:
+    template<typename T>
+    static constexpr T abs(T value) {
+        if (std::is_constant_evaluated()) {
+            return value < T(0) ? -value : value;
+        }
+        return std::abs(value);
+    }
+
+    template<typename T>
+    static constexpr T sqrt(T value) {
+        if (std::is_constant_evaluated()) {
+            if constexpr (std::is_integral_v<T>) {
+                return static_cast<T>(newtonSqrt(static_cast<long double>(value)));
+            } else if constexpr (sizeof(T) < sizeof(long double)) {
+                // The extra precision makes the final rounding match std::sqrt
+                return static_cast<T>(newtonSqrt(static_cast<long double>(value)));
+            } else {
+                return newtonSqrt(value);
+            }
+        }
+        return static_cast<T>(std::sqrt(value));
+    }
+
+private:
+    template<typename T>
+    static constexpr T newtonSqrt(T value) {
+        if (value != value || value < T(0)) {
+            return std::numeric_limits<T>::quiet_NaN();
+        }
+        if (value == T(0) || value == std::numeric_limits<T>::infinity()) {
+            return value;
+        }
+
+        // Scale into [0.25, 4] by powers of four so Newton converges in a handful of steps
+        T scale = 1;
+        while (value > T(4)) {
+            value /= 4;
+            scale *= 2;
+        }
+        while (value < T(0.25)) {
+            value *= 4;
+            scale /= 2;
+        }
+
+        T guess = 1;
+        for (int i = 0; i < 64; ++i) {
+            T next = (guess + value / guess) / 2;
+            if (next == guess) {
+                break;
+            }
+            guess = next;
+        }
+        return guess * scale;
+    }
+};
+
+#endif // CONSTEXPR_MATH_HPP
@@ -4,23 +4,34 @@
 #include <vector>
 #include <cmath>
 
+#include "Concepts.hpp"
+#include "ExactArithmetic.hpp"
+#include "Executor.hpp"
+#include "MatrixView.hpp"
+#include "Workspace.hpp"
+
 template<typename T>
 class LaplaceExpansion {
 public:
-    static T calculate(const std::vector<std::vector<T>>& matrix) {
+    template<RowIndexable<T> Rows>
+    static T calculate(const Rows& matrix) {
+        WorkspaceScope workspace;
         return determinant(matrix);
     }
 
 private:
-    static T determinant(const std::vector<std::vector<T>>& matrix) {
+    template<typename Rows>
+    static T determinant(const Rows& matrix) {
         int N = matrix.size();
         if (N == 1) {
             return matrix[0][0];
         } else {
+            WorkspaceScope workspace;
             T det = 0;
             int sign = 1;
+            WorkspaceMatrix<T> subMatrix = makeWorkspaceMatrix<T>(N - 1, N - 1);
             for (int i = 0; i < N; ++i) {
-                std::vector<std::vector<T>> subMatrix = createSubMatrix(matrix, 0, i);
+                fillSubMatrix(matrix, subMatrix, 0, i);
 
                 det += sign * matrix[0][i] * determinant(subMatrix);
                 sign = -sign;
@@ -29,25 +40,28 @@ private:
         }
     }
 
-    static std::vector<std::vector<T>> createSubMatrix(const std::vector<std::vector<T>>& matrix, int excludingRow, int excludingCol) {
+    template<typename Rows>
+    static void fillSubMatrix(const Rows& matrix, WorkspaceMatrix<T>& subMatrix, int excludingRow, int excludingCol) {
         int N = matrix.size();
-        std::vector<std::vector<T>> subMatrix;
-        for (int i = 0; i < N; ++i) {
+        for (int i = 0, m = 0; i < N; ++i) {
             if (i == excludingRow) continue;
-            std::vector<T> row;
-            for (int j = 0; j < N; ++j) {
+            for (int j = 0, n = 0; j < N; ++j) {
                 if (j == excludingCol) continue;
-                row.push_back(matrix[i][j]);
+                subMatrix[m][n++] = matrix[i][j];
             }
-            subMatrix.push_back(row);
+            ++m;
         }
-        return subMatrix;
     }
 };
 
 template<typename T>
 class GaussianElimination {
 public:
+    template<RowIndexable<T> Rows>
+    static T calculate(const Rows& matrix) {
+        return calculate(denseRows<T>(matrix));
+    }
+
     static T calculate(std::vector<std::vector<T>> matrix) {
         int M = matrix.size();
         int N = matrix[0].size();
@@ -86,8 +100,51 @@ private:
 };
 
 
+// Fraction-free Gaussian elimination (Bareiss) for integer T: every intermediate value is a
+// minor of the matrix, so the determinant is exact in O(n^3) as long as the minors fit in T
+template<typename T>
+class BareissDeterminant {
+public:
+    template<RowIndexable<T> Rows>
+    static T calculate(const Rows& matrix) {
+        int n = matrix.size();
+        if (n == 0) {
+            return T(1);
+        }
+        std::vector<std::vector<T>> a = denseRows<T>(matrix);
+        int sign = BareissKernels<T>::eliminate(a, n);
+        if (sign == 0) {
+            return T(0);
+        }
+        return sign > 0 ? a[n - 1][n - 1] : -a[n - 1][n - 1];
+    }
+};
 
-
-
+// The determinant of an integer matrix modulo enough primes below 2^31 to cover its Hadamard
+// bound, recombined by the Chinese remainder theorem. Nothing but the result has to fit in T
+// (std::overflow_error is thrown if it does not), so it suits entries whose minors overflow
+// Bareiss; the primes run in parallel.
+template<typename T>
+class ModularDeterminant {
+public:
+    template<RowIndexable<T> Rows>
+    static T calculate(const Rows& matrix) {
+        if (matrix.size() == 0) {
+            return T(1);
+        }
+        const auto& a = denseRows<T>(matrix);
+        int count = ModularArithmetic::primesFor(ModularArithmetic::hadamardBits<T>(a));
+        std::vector<long long> primes(count);
+        std::vector<long long> residues(count);
+        for (int i = 0; i < count; ++i) {
+            primes[i] = ModularArithmetic::prime(i);
+        }
+        MatrixExecutor::current().parallelFor(count, [&](int i) {
+            auto reduced = ModularArithmetic::residues<T>(a, primes[i]);
+            residues[i] = ModularArithmetic::solve(reduced, nullptr, primes[i]);
+        });
+        return ModularArithmetic::reconstruct<T>(residues, primes);
+    }
+};
 
 #endif // DETERMINANT_POLICIES_HPP
@@ -7,10 +7,13 @@
 #include <algorithm>
 #include <stdexcept>
 
+#include "Concepts.hpp"
+
 template<typename T>
 class PowerIteration {
 public:
-    static std::pair<T, std::vector<T>> calculate(const std::vector<std::vector<T>>& matrix, int maxIterations = 1000, T tolerance = 1e-10) {
+    template<RowIndexable<T> Rows>
+    static std::pair<T, std::vector<T>> calculate(const Rows& matrix, int maxIterations = 1000, T tolerance = 1e-10) {
         int n = matrix.size();
         std::vector<T> b_k(n, 1);
 
@@ -36,7 +39,8 @@ public:
     }
 
 private:
-    static std::vector<T> multiply(const std::vector<std::vector<T>>& matrix, const std::vector<T>& vec) {
+    template<typename Rows>
+    static std::vector<T> multiply(const Rows& matrix, const std::vector<T>& vec) {
         std::vector<T> result(vec.size(), 0);
         for (size_t i = 0; i < matrix.size(); ++i)
             for (size_t j = 0; j < matrix[0].size(); ++j)
@@ -0,0 +1,422 @@
+#ifndef EXACT_ARITHMETIC_HPP
+#define EXACT_ARITHMETIC_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Concepts.hpp"
+
+// Exact linear algebra over integer types (int, long long or an arbitrary-precision integer
+// class): fractions for exact solutions, Bareiss' fraction-free elimination, and elimination
+// modulo word-sized primes with Chinese remaindering for entries whose intermediate minors
+// would not fit in T.
+
+// T is any ExactInteger
+template<typename T>
+class Rational {
+public:
+    constexpr Rational() : num(0), den(1) {}
+
+    constexpr Rational(T numerator, T denominator = T(1)) : num(std::move(numerator)), den(std::move(denominator)) {
+        if (den == T(0)) {
+            throw std::invalid_argument("Denominator must not be zero.");
+        }
+        normalize();
+    }
+
+    constexpr const T& numerator() const {
+        return num;
+    }
+
+    constexpr const T& denominator() const {
+        return den;
+    }
+
+    constexpr Rational operator-() const {
+        return Rational(-num, den);
+    }
+
+    friend constexpr Rational operator+(const Rational& a, const Rational& b) {
+        return Rational(a.num * b.den + b.num * a.den, a.den * b.den);
+    }
+
+    friend constexpr Rational operator-(const Rational& a, const Rational& b) {
+        return Rational(a.num * b.den - b.num * a.den, a.den * b.den);
+    }
+
+    friend constexpr Rational operator*(const Rational& a, const Rational& b) {
+        return Rational(a.num * b.num, a.den * b.den);
+    }
+
+    friend constexpr Rational operator/(const Rational& a, const Rational& b) {
+        return Rational(a.num * b.den, a.den * b.num);
+    }
+
+    // Both sides are in lowest terms with a positive denominator, so equal values match term by term
+    friend constexpr bool operator==(const Rational& a, const Rational& b) {
+        return a.num == b.num && a.den == b.den;
+    }
+
+    friend constexpr bool operator<(const Rational& a, const Rational& b) {
+        return a.num * b.den < b.num * a.den;
+    }
+
+    friend constexpr bool operator>(const Rational& a, const Rational& b) {
+        return b < a;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Rational& value) {
+        os << value.num;
+        if (!(value.den == T(1))) {
+            os << "/" << value.den;
+        }
+        return os;
+    }
+
+private:
+    constexpr void normalize() {
+        if (den < T(0)) {
+            num = -num;
+            den = -den;
+        }
+        T divisor = gcd(num < T(0) ? -num : num, den);
+        if (!(divisor == T(1))) {
+            num = num / divisor;
+            den = den / divisor;
+        }
+    }
+
+    static constexpr T gcd(T a, T b) {
+        while (!(b == T(0))) {
+            T r = a % b;
+            a = std::move(b);
+            b = std::move(r);
+        }
+        return a;
+    }
+
+    T num;
+    T den;
+};
+
+template<ExactInteger T>
+class BareissKernels {
+public:
+    // One-step fraction-free elimination of the first n columns of `a` (n x cols, cols >= n),
+    // swapping rows for nonzero pivots. Every entry stays a minor of the input, so each division
+    // is exact and the last pivot is the determinant of the row-permuted leading n x n block.
+    // Returns the sign of that permutation, or 0 if the block is singular.
+    static int eliminate(std::vector<std::vector<T>>& a, int n) {
+        int cols = n > 0 ? static_cast<int>(a[0].size()) : 0;
+        int sign = 1;
+        T previous(1);
+        for (int k = 0; k < n; ++k) {
+            int pivot = k;
+            while (pivot < n && a[pivot][k] == T(0)) {
+                ++pivot;
+            }
+            if (pivot == n) {
+                return 0;
+            }
+            if (pivot != k) {
+                std::swap(a[pivot], a[k]);
+                sign = -sign;
+            }
+            for (int i = k + 1; i < n; ++i) {
+                for (int j = k + 1; j < cols; ++j) {
+                    a[i][j] = step(a[k][k], a[i][j], a[i][k], a[k][j], previous);
+                }
+                a[i][k] = T(0);
+            }
+            previous = a[k][k];
+        }
+        return sign;
+    }
+
+    // Fraction-free back substitution after eliminate(a, n) on [A | b] (n x (n + 1)): returns
+    // y = det(A) * x, which is integral by Cramer's rule, so every division is exact. The
+    // products and sums are formed in Wide; std::overflow_error is thrown if one of them or an
+    // entry of y does not fit.
+    static std::vector<T> substitute(const std::vector<std::vector<T>>& a, int n) {
+        const T& det = a[n - 1][n - 1];
+        std::vector<T> y(n);
+        for (int i = n - 1; i >= 0; --i) {
+            Wide sum = multiply(det, a[i][n]);
+            for (int j = i + 1; j < n; ++j) {
+                sum = subtract(sum, multiply(a[i][j], y[j]));
+            }
+            y[i] = narrow(sum / Wide(a[i][i]));
+        }
+        return y;
+    }
+
+private:
+    // Built-in integers form the two products in a type twice as wide, so the result is exact
+    // whenever the minor itself fits in T; a minor that does not throws std::overflow_error
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef __int128 Int128;
+#else
+    typedef long long Int128;
+#endif
+    using Wide = std::conditional_t<std::is_integral_v<T> && sizeof(T) <= 4, long long,
+                 std::conditional_t<std::is_integral_v<T> && sizeof(T) <= 8, Int128, T>>;
+
+    static T step(const T& pivot, const T& entry, const T& left, const T& top, const T& previous) {
+        return narrow((Wide(pivot) * Wide(entry) - Wide(left) * Wide(top)) / Wide(previous));
+    }
+
+    // Without a type twice as wide (long long without __int128) the products themselves are checked
+    static Wide multiply(const T& a, const T& b) {
+#if defined(__GNUC__) || defined(__clang__)
+        if constexpr (std::is_integral_v<T>) {
+            Wide product;
+            if (__builtin_mul_overflow(Wide(a), Wide(b), &product)) {
+                throw std::overflow_error("Intermediate result of exact elimination does not fit in the integer type.");
+            }
+            return product;
+        }
+#endif
+        return Wide(a) * Wide(b);
+    }
+
+    static Wide subtract(const Wide& a, const Wide& b) {
+#if defined(__GNUC__) || defined(__clang__)
+        if constexpr (std::is_integral_v<T>) {
+            Wide difference;
+            if (__builtin_sub_overflow(a, b, &difference)) {
+                throw std::overflow_error("Intermediate result of exact elimination does not fit in the integer type.");
+            }
+            return difference;
+        }
+#endif
+        return a - b;
+    }
+
+    static T narrow(const Wide& value) {
+        if constexpr (std::numeric_limits<T>::is_bounded) {
+            if (value < Wide(std::numeric_limits<T>::min()) || value > Wide(std::numeric_limits<T>::max())) {
+                throw std::overflow_error("Intermediate result of exact elimination does not fit in the integer type.");
+            }
+        }
+        return static_cast<T>(value);
+    }
+};
+
+// Arithmetic modulo primes just below 2^31, whose products fit in 64 bits
+class ModularArithmetic {
+public:
+    // The index-th prime below 2^31 in descending order
+    static long long prime(int index) {
+        static std::mutex mutex;
+        static std::vector<long long> primes;
+        std::lock_guard<std::mutex> lock(mutex);
+        long long candidate = primes.empty() ? 2147483647 : primes.back() - 2;
+        while (static_cast<int>(primes.size()) <= index) {
+            if (isPrime(candidate)) {
+                primes.push_back(candidate);
+            }
+            candidate -= 2;
+        }
+        return primes[index];
+    }
+
+    static long long multiply(long long a, long long b, long long p) {
+        return a * b % p;
+    }
+
+    static long long power(long long base, long long exponent, long long p) {
+        long long result = 1;
+        base %= p;
+        while (exponent > 0) {
+            if (exponent & 1) {
+                result = multiply(result, base, p);
+            }
+            base = multiply(base, base, p);
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+    static long long inverse(long long a, long long p) {
+        return power(a, p - 2, p);
+    }
+
+    template<ExactInteger T>
+    static long long residue(const T& value, long long p) {
+        long long r;
+        if constexpr (std::is_integral_v<T>) {
+            r = static_cast<long long>(value) % p;
+        } else {
+            r = static_cast<long long>(value % T(p));
+        }
+        return r < 0 ? r + p : r;
+    }
+
+    // log2 of the Hadamard bound |det| <= prod_i ||row_i|| <= prod_i sqrt(n) max_j |a_ij|, which
+    // also bounds every minor of `rows`
+    template<ExactInteger T, typename Rows>
+    static double hadamardBits(const Rows& rows) {
+        double bits = 0;
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            int largest = 0;
+            for (std::size_t j = 0; j < rows[i].size(); ++j) {
+                largest = std::max(largest, bitLength(T(rows[i][j])));
+            }
+            bits += largest + 0.5 * std::log2(static_cast<double>(rows[i].size()));
+        }
+        return bits;
+    }
+
+    // Number of primes from prime(0) on whose product exceeds 2^(bits + 1)
+    static int primesFor(double bits) {
+        return static_cast<int>(std::ceil((bits + 1) / 30.0)) + 1;
+    }
+
+    // The value in (-P/2, P/2), P the product of primes, with the given residues. Garner's
+    // algorithm gives its mixed-radix digits, so nothing wider than T and 64 bits is needed.
+    // Every partial sum of the digits is at most the value itself, so a built-in T overflows
+    // only if the value does not fit, and then std::overflow_error is thrown.
+    template<ExactInteger T>
+    static T reconstruct(const std::vector<long long>& residues, const std::vector<long long>& primes) {
+        int k = static_cast<int>(primes.size());
+        std::vector<long long> digits(k);
+        for (int i = 0; i < k; ++i) {
+            long long x = residues[i];
+            for (int j = 0; j < i; ++j) {
+                x = multiply((x - digits[j] % primes[i] + primes[i]) % primes[i], inverse(primes[j] % primes[i], primes[i]), primes[i]);
+            }
+            digits[i] = x;
+        }
+
+        // P is odd, so (P - 1) / 2 has the mixed-radix digits (p_i - 1) / 2
+        bool negative = false;
+        for (int i = k - 1; i >= 0; --i) {
+            long long half = (primes[i] - 1) / 2;
+            if (digits[i] != half) {
+                negative = digits[i] > half;
+                break;
+            }
+        }
+        if (negative) {
+            // -(P - value) = -((P - 1 - value) + 1), whose digits are p_i - 1 - d_i
+            for (int i = 0; i < k; ++i) {
+                digits[i] = primes[i] - 1 - digits[i];
+            }
+        }
+        T value(0);
+        for (int i = k - 1; i >= 0; --i) {
+            if constexpr (std::numeric_limits<T>::is_bounded) {
+                // value, the digit and the prime are non-negative and below 2^63
+                unsigned long long largest = static_cast<unsigned long long>(std::numeric_limits<T>::max());
+                unsigned long long digit = static_cast<unsigned long long>(digits[i]);
+                unsigned long long radix = static_cast<unsigned long long>(primes[i]);
+                if (digit > largest || static_cast<unsigned long long>(value) > (largest - digit) / radix) {
+                    throw std::overflow_error("Exact result does not fit in the integer type.");
+                }
+            }
+            value = value * T(primes[i]) + T(digits[i]);
+        }
+        return negative ? -value - T(1) : value;
+    }
+
+    // Determinant of `a` (n x n) modulo p, and x with a x = b when b is given and a is
+    // invertible modulo p; elimination with any nonzero pivot
+    static long long solve(std::vector<std::vector<long long>>& a, std::vector<long long>* b, long long p) {
+        int n = a.size();
+        long long det = 1;
+        for (int k = 0; k < n; ++k) {
+            int pivot = k;
+            while (pivot < n && a[pivot][k] == 0) {
+                ++pivot;
+            }
+            if (pivot == n) {
+                return 0;
+            }
+            if (pivot != k) {
+                std::swap(a[pivot], a[k]);
+                if (b != nullptr) {
+                    std::swap((*b)[pivot], (*b)[k]);
+                }
+                det = p - det;
+            }
+            det = multiply(det, a[k][k], p);
+            long long pivotInverse = inverse(a[k][k], p);
+            for (int i = k + 1; i < n; ++i) {
+                long long factor = multiply(a[i][k], pivotInverse, p);
+                if (factor == 0) {
+                    continue;
+                }
+                for (int j = k; j < n; ++j) {
+                    a[i][j] = (a[i][j] + multiply(p - factor, a[k][j], p)) % p;
+                }
+                if (b != nullptr) {
+                    (*b)[i] = ((*b)[i] + multiply(p - factor, (*b)[k], p)) % p;
+                }
+            }
+        }
+        if (b != nullptr) {
+            for (int i = n - 1; i >= 0; --i) {
+                long long sum = (*b)[i];
+                for (int j = i + 1; j < n; ++j) {
+                    sum = (sum + multiply(p - a[i][j], (*b)[j], p)) % p;
+                }
+                (*b)[i] = multiply(sum, inverse(a[i][i], p), p);
+            }
+        }
+        return det % p;
+    }
+
+    template<ExactInteger T, typename Rows>
+    static std::vector<std::vector<long long>> residues(const Rows& matrix, long long p) {
+        std::vector<std::vector<long long>> result(matrix.size());
+        for (std::size_t i = 0; i < matrix.size(); ++i) {
+            result[i].resize(matrix[i].size());
+            for (std::size_t j = 0; j < matrix[i].size(); ++j) {
+                result[i][j] = residue(T(matrix[i][j]), p);
+            }
+        }
+        return result;
+    }
+
+private:
+    static bool isPrime(long long n) {
+        if (n % 2 == 0) {
+            return n == 2;
+        }
+        for (long long d = 3; d * d <= n; d += 2) {
+            if (n % d == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<ExactInteger T>
+    // Bits of |value|, or one more for a negative value, whose magnitude may not fit in T
+    static int bitLength(T value) {
+        int bits = 0;
+        if (value < T(0)) {
+            value = -(value + T(1));
+            bits = 1;
+        }
+        while (!(value < T(65536))) {
+            value = value / T(65536);
+            bits += 16;
+        }
+        while (!(value == T(0))) {
+            value = value / T(2);
+            ++bits;
+        }
+        return bits;
+    }
+};
+
+#endif // EXACT_ARITHMETIC_HPP
@@ -0,0 +1,458 @@
+#ifndef EXECUTOR_HPP
+#define EXECUTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// The thread pool behind everything in the library that runs in parallel: the asynchronous
+// Matrix methods (solveAsync, multiplyAsync, ...), TaskGraph and the parallel loops inside
+// policies. Sharing one pool keeps nested parallel calls from oversubscribing the machine.
+
+class OperationCancelled : public std::runtime_error {
+public:
+    OperationCancelled() : std::runtime_error("Matrix operation was cancelled.") {}
+};
+
+// Observes a CancellationSource; a default-constructed token is never cancelled
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    bool cancelled() const {
+        return state && state->load(std::memory_order_acquire);
+    }
+
+    void throwIfCancelled() const {
+        if (cancelled()) {
+            throw OperationCancelled();
+        }
+    }
+
+private:
+    friend class CancellationSource;
+
+    explicit CancellationToken(std::shared_ptr<const std::atomic<bool>> state) : state(std::move(state)) {}
+
+    std::shared_ptr<const std::atomic<bool>> state;
+};
+
+class CancellationSource {
+public:
+    CancellationSource() : state(std::make_shared<std::atomic<bool>>(false)) {}
+
+    CancellationToken token() const {
+        return CancellationToken(state);
+    }
+
+    // Tasks that have not started yet finish with OperationCancelled instead of running
+    void cancel() {
+        state->store(true, std::memory_order_release);
+    }
+
+    bool cancelled() const {
+        return state->load(std::memory_order_acquire);
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> state;
+};
+
+// Lets instrumentation follow work across threads. A task pushed to an executor while an
+// observer is installed on the pushing thread is handed to that observer's run() on whichever
+// thread picks it up; without one, tasks run as they are.
+class TaskObserver {
+public:
+    virtual ~TaskObserver() = default;
+
+    virtual void run(const std::function<void()>& task) = 0;
+
+    static const std::shared_ptr<TaskObserver>& current() {
+        return installed();
+    }
+
+    // Makes `observer` the calling thread's observer and returns the one it replaces
+    static std::shared_ptr<TaskObserver> install(std::shared_ptr<TaskObserver> observer) {
+        std::swap(installed(), observer);
+        return observer;
+    }
+
+private:
+    static std::shared_ptr<TaskObserver>& installed() {
+        thread_local std::shared_ptr<TaskObserver> observer;
+        return observer;
+    }
+};
+
+// A work-stealing pool. Each worker owns a deque: it pushes and pops its own tasks at the
+// back (most recently produced, still in cache) and, when that runs dry, steals the oldest
+// task from the front of another worker's deque. Work started from inside a worker runs
+// inline rather than being queued behind the task that waits for it, so nested parallel
+// calls neither deadlock nor add threads.
+class MatrixExecutor {
+public:
+    // Worker i is pinned to cpus[i % cpus.size()] where the platform supports it; an empty
+    // list leaves placement to the OS. submit() blocks once queueCapacity tasks wait to start.
+    explicit MatrixExecutor(int threads = defaultThreadCount(), std::vector<int> cpus = {}, std::size_t queueCapacity = 256)
+        : cpus(std::move(cpus)), capacity(std::max<std::size_t>(queueCapacity, 1)) {
+        if (threads < 1) {
+            throw std::invalid_argument("An executor needs at least one thread.");
+        }
+        for (int cpu : this->cpus) {
+            if (cpu < 0) {
+                throw std::invalid_argument("CPU indices must not be negative.");
+            }
+        }
+        for (int i = 0; i < threads; ++i) {
+            queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        workers.reserve(threads);
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    // Runs everything already queued, then joins the workers
+    ~MatrixExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        {
+            std::lock_guard<std::mutex> lock(submitMutex);
+            submitStopping = true;
+        }
+        wake.notify_all();
+        notFull.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    MatrixExecutor(const MatrixExecutor&) = delete;
+    MatrixExecutor& operator=(const MatrixExecutor&) = delete;
+
+    // The library-wide executor, used unless a policy set or an ExecutorScope names another
+    static MatrixExecutor& shared() {
+        static MatrixExecutor executor;
+        return executor;
+    }
+
+    // The executor parallel code on this thread should use: the innermost ExecutorScope's,
+    // else the one this thread is a worker of, else shared()
+    static MatrixExecutor& current() {
+        if (scoped() != nullptr) {
+            return *scoped();
+        }
+        if (currentExecutor() != nullptr) {
+            return *currentExecutor();
+        }
+        return shared();
+    }
+
+    // Queues `task` and returns a future for its result, blocking while the queue is full.
+    // Called from one of this executor's own threads, the task runs inline instead: a worker
+    // waiting on work queued behind it could otherwise deadlock.
+    template<typename F>
+    std::future<std::invoke_result_t<std::decay_t<F>>> submit(F&& task, CancellationToken token = {}) {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(
+            [task = std::forward<F>(task), token]() mutable -> Result {
+                token.throwIfCancelled();
+                return task();
+            });
+        std::future<Result> result = packaged->get_future();
+
+        if (inWorker()) {
+            (*packaged)();
+            return result;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(submitMutex);
+            if (submitStopping) {
+                throw std::runtime_error("Cannot submit to an executor that is shutting down.");
+            }
+            notFull.wait(lock, [this] { return submitted < capacity || submitStopping; });
+            ++submitted;
+        }
+        push([this, packaged] {
+            {
+                std::lock_guard<std::mutex> lock(submitMutex);
+                --submitted;
+            }
+            notFull.notify_one();
+            (*packaged)();
+        });
+        return result;
+    }
+
+    // Runs body(i) for every i in [0, count) and returns when all have finished, rethrowing
+    // the first exception. Indices are handed out dynamically to up to threadCount() tasks;
+    // the calling thread takes part. Inside a worker the loop runs inline.
+    template<typename F>
+    void parallelFor(int count, F&& body) {
+        int chunks = inWorker() ? 1 : std::min(count, threadCount());
+        if (chunks <= 1) {
+            for (int i = 0; i < count; ++i) {
+                body(i);
+            }
+            return;
+        }
+
+        LoopState state(count, chunks);
+        for (int chunk = 1; chunk < chunks; ++chunk) {
+            push([&state, &body] { runChunk(state, body); });
+        }
+        runChunk(state, body);
+        // unfinished is only touched under the mutex, so once it reads zero no chunk still
+        // refers to state
+        for (;;) {
+            if (runOne()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(state.mutex);
+            if (state.done.wait_for(lock, std::chrono::microseconds(200), [&state] { return state.unfinished == 0; })) {
+                break;
+            }
+        }
+        if (state.failure) {
+            std::rethrow_exception(state.failure);
+        }
+    }
+
+    // Pushes onto the calling worker's own deque, or round-robin from other threads
+    void push(std::function<void()> task) {
+        int index = currentIndex();
+        if (index < 0) {
+            index = static_cast<int>(nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size());
+        }
+        if (const auto& observer = TaskObserver::current()) {
+            task = [observer, task = std::move(task)] { observer->run(task); };
+        }
+        // Counted before it is visible, so the count never drops below the number of queued tasks
+        queued.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wake.notify_one();
+    }
+
+    // Runs one queued task on the calling thread, if there is one. Lets a thread that waits
+    // for pool work (a worker or not) help instead of blocking.
+    bool runOne() {
+        std::function<void()> task;
+        if (!take(currentIndex(), task)) {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+    // True on the executor's own threads
+    bool inWorker() const {
+        return currentExecutor() == this;
+    }
+
+    int threadCount() const {
+        return static_cast<int>(workers.size());
+    }
+
+    const std::vector<int>& cpuAffinity() const {
+        return cpus;
+    }
+
+    std::size_t queueCapacity() const {
+        return capacity;
+    }
+
+    // Submitted tasks that have not started yet
+    std::size_t pending() const {
+        std::lock_guard<std::mutex> lock(submitMutex);
+        return submitted;
+    }
+
+    static int defaultThreadCount() {
+        return static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    }
+
+private:
+    friend class ExecutorScope;
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    struct LoopState {
+        LoopState(int count, int chunks) : count(count), unfinished(chunks) {}
+
+        int count;
+        std::atomic<int> next{0};
+        int unfinished;
+        std::exception_ptr failure;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    template<typename F>
+    static void runChunk(LoopState& state, F& body) {
+        try {
+            for (int i = state.next.fetch_add(1, std::memory_order_relaxed); i < state.count; i = state.next.fetch_add(1, std::memory_order_relaxed)) {
+                body(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (!state.failure) {
+                state.failure = std::current_exception();
+            }
+            state.next.store(state.count, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (--state.unfinished == 0) {
+            state.done.notify_all();
+        }
+    }
+
+    static MatrixExecutor*& currentExecutor() {
+        thread_local MatrixExecutor* executor = nullptr;
+        return executor;
+    }
+
+    static MatrixExecutor*& scoped() {
+        thread_local MatrixExecutor* executor = nullptr;
+        return executor;
+    }
+
+    static int& currentWorker() {
+        thread_local int index = -1;
+        return index;
+    }
+
+    int currentIndex() const {
+        return inWorker() ? currentWorker() : -1;
+    }
+
+    bool take(int self, std::function<void()>& task) {
+        if (queued.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        if (self >= 0) {
+            std::lock_guard<std::mutex> lock(queues[self]->mutex);
+            if (!queues[self]->tasks.empty()) {
+                task = std::move(queues[self]->tasks.back());
+                queues[self]->tasks.pop_back();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        int count = static_cast<int>(queues.size());
+        int start = self >= 0 ? self + 1 : 0;
+        for (int offset = 0; offset < count; ++offset) {
+            int victim = (start + offset) % count;
+            if (victim == self) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(queues[victim]->mutex);
+            if (!queues[victim]->tasks.empty()) {
+                task = std::move(queues[victim]->tasks.front());
+                queues[victim]->tasks.pop_front();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void pin(int index) {
+#if defined(__linux__)
+        if (!cpus.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[index % cpus.size()], &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+#else
+        (void)index;
+#endif
+    }
+
+    void run(int index) {
+        currentExecutor() = this;
+        currentWorker() = index;
+        pin(index);
+        for (;;) {
+            std::function<void()> task;
+            if (take(index, task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] { return queued.load(std::memory_order_acquire) > 0 || stopping; });
+            if (stopping && queued.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<int> cpus;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> queued{0};
+    std::atomic<std::size_t> nextQueue{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    mutable std::mutex submitMutex;
+    std::condition_variable notFull;
+    std::size_t submitted = 0;
+    std::size_t capacity;
+    bool submitStopping = false;
+};
+
+// Makes `executor` the one MatrixExecutor::current() returns on this thread until the scope
+// closes; Matrix opens one around every policy call with the policy set's executor
+class ExecutorScope {
+public:
+    // nullptr keeps the enclosing scope's executor
+    explicit ExecutorScope(MatrixExecutor* executor) : previous(MatrixExecutor::scoped()) {
+        if (executor != nullptr) {
+            MatrixExecutor::scoped() = executor;
+        }
+    }
+
+    ~ExecutorScope() {
+        MatrixExecutor::scoped() = previous;
+    }
+
+    ExecutorScope(const ExecutorScope&) = delete;
+    ExecutorScope& operator=(const ExecutorScope&) = delete;
+
+private:
+    MatrixExecutor* previous;
+};
+
+#endif // EXECUTOR_HPP
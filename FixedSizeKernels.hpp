@@ -0,0 +1,394 @@
+#ifndef FIXED_SIZE_KERNELS_HPP
+#define FIXED_SIZE_KERNELS_HPP
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "ConstexprMath.hpp"
+
+// Calls f(std::integral_constant<int, I>{}) for I = 0..N-1, fully unrolled at compile time.
+template<int N, typename F>
+constexpr void staticFor(F&& f) {
+    [&]<int... I>(std::integer_sequence<int, I...>) {
+        (f(std::integral_constant<int, I>{}), ...);
+    }(std::make_integer_sequence<int, N>{});
+}
+
+constexpr int StaticForUnrollLimit = 8;
+
+// staticFor for small N; a plain loop beyond that so large constant-evaluated sizes stay cheap to compile.
+template<int N, typename F>
+constexpr void unrolledFor(F&& f) {
+    if constexpr (N <= StaticForUnrollLimit) {
+        staticFor<N>(f);
+    } else {
+        for (int i = 0; i < N; ++i) {
+            f(i);
+        }
+    }
+}
+
+// Stack-only kernels for matrices whose dimensions are known at compile time. They are
+// constexpr, so Matrix also uses them for constant evaluation at any size.
+// Closed forms are used up to 4x4. Larger sizes use elimination for floating point T
+// and cofactor expansion otherwise, so integral results stay exact.
+template<typename T>
+class FixedSizeKernels {
+public:
+    // Above 4 x 4 the integral kernels expand cofactors in O(N!), so at run time those sizes go
+    // to the configured policies; constant evaluation still uses them
+    template<int N>
+    static constexpr bool supportsDeterminant = N <= 4 || std::is_floating_point_v<T>;
+
+    template<int N>
+    static constexpr bool supportsInverse = N <= 4 || std::is_floating_point_v<T>;
+
+    static constexpr bool supportsCholesky = std::is_floating_point_v<T>;
+
+    template<int N>
+    static constexpr T determinant(const T (&a)[N][N]) {
+        if constexpr (N == 1) {
+            return a[0][0];
+        } else if constexpr (N == 2) {
+            return a[0][0] * a[1][1] - a[0][1] * a[1][0];
+        } else if constexpr (N == 3) {
+            return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+                 - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+                 + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+        } else if constexpr (N == 4) {
+            T s[6]{}, c[6]{};
+            pairMinors(a, s, c);
+            return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+        } else if constexpr (!std::is_floating_point_v<T>) {
+            T det = 0;
+            T sign = 1;
+            for (int col = 0; col < N; ++col) {
+                T sub[N - 1][N - 1]{};
+                minor(a, 0, col, sub);
+                det += sign * a[0][col] * determinant(sub);
+                sign = -sign;
+            }
+            return det;
+        } else {
+            T m[N][N]{};
+            copy(a, m);
+            T det = 1;
+            for (int i = 0; i < N; ++i) {
+                int pivot = findPivotRow(m, i);
+                if (m[pivot][i] == 0) {
+                    return 0;
+                }
+                if (pivot != i) {
+                    swapRows(m, i, pivot);
+                    det = -det;
+                }
+                det *= m[i][i];
+                for (int r = i + 1; r < N; ++r) {
+                    T factor = m[r][i] / m[i][i];
+                    for (int k = i; k < N; ++k) {
+                        m[r][k] -= factor * m[i][k];
+                    }
+                }
+            }
+            return det;
+        }
+    }
+
+    template<int N>
+    static constexpr void inverse(const T (&a)[N][N], T (&out)[N][N]) {
+        if constexpr (N == 1) {
+            if (a[0][0] == 0) singular();
+            out[0][0] = T(1) / a[0][0];
+        } else if constexpr (N == 2) {
+            T det = determinant(a);
+            if (det == 0) singular();
+            out[0][0] = a[1][1] / det;
+            out[0][1] = -a[0][1] / det;
+            out[1][0] = -a[1][0] / det;
+            out[1][1] = a[0][0] / det;
+        } else if constexpr (N == 3) {
+            T c00 = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+            T c01 = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+            T c02 = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+            T det = a[0][0] * c00 + a[0][1] * c01 + a[0][2] * c02;
+            if (det == 0) singular();
+            out[0][0] = c00 / det;
+            out[1][0] = c01 / det;
+            out[2][0] = c02 / det;
+            out[0][1] = (a[0][2] * a[2][1] - a[0][1] * a[2][2]) / det;
+            out[1][1] = (a[0][0] * a[2][2] - a[0][2] * a[2][0]) / det;
+            out[2][1] = (a[0][1] * a[2][0] - a[0][0] * a[2][1]) / det;
+            out[0][2] = (a[0][1] * a[1][2] - a[0][2] * a[1][1]) / det;
+            out[1][2] = (a[0][2] * a[1][0] - a[0][0] * a[1][2]) / det;
+            out[2][2] = (a[0][0] * a[1][1] - a[0][1] * a[1][0]) / det;
+        } else if constexpr (N == 4) {
+            T s[6]{}, c[6]{};
+            pairMinors(a, s, c);
+            T det = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+            if (det == 0) singular();
+            out[0][0] = ( a[1][1] * c[5] - a[1][2] * c[4] + a[1][3] * c[3]) / det;
+            out[0][1] = (-a[0][1] * c[5] + a[0][2] * c[4] - a[0][3] * c[3]) / det;
+            out[0][2] = ( a[3][1] * s[5] - a[3][2] * s[4] + a[3][3] * s[3]) / det;
+            out[0][3] = (-a[2][1] * s[5] + a[2][2] * s[4] - a[2][3] * s[3]) / det;
+            out[1][0] = (-a[1][0] * c[5] + a[1][2] * c[2] - a[1][3] * c[1]) / det;
+            out[1][1] = ( a[0][0] * c[5] - a[0][2] * c[2] + a[0][3] * c[1]) / det;
+            out[1][2] = (-a[3][0] * s[5] + a[3][2] * s[2] - a[3][3] * s[1]) / det;
+            out[1][3] = ( a[2][0] * s[5] - a[2][2] * s[2] + a[2][3] * s[1]) / det;
+            out[2][0] = ( a[1][0] * c[4] - a[1][1] * c[2] + a[1][3] * c[0]) / det;
+            out[2][1] = (-a[0][0] * c[4] + a[0][1] * c[2] - a[0][3] * c[0]) / det;
+            out[2][2] = ( a[3][0] * s[4] - a[3][1] * s[2] + a[3][3] * s[0]) / det;
+            out[2][3] = (-a[2][0] * s[4] + a[2][1] * s[2] - a[2][3] * s[0]) / det;
+            out[3][0] = (-a[1][0] * c[3] + a[1][1] * c[1] - a[1][2] * c[0]) / det;
+            out[3][1] = ( a[0][0] * c[3] - a[0][1] * c[1] + a[0][2] * c[0]) / det;
+            out[3][2] = (-a[3][0] * s[3] + a[3][1] * s[1] - a[3][2] * s[0]) / det;
+            out[3][3] = ( a[2][0] * s[3] - a[2][1] * s[1] + a[2][2] * s[0]) / det;
+        } else if constexpr (!std::is_floating_point_v<T>) {
+            T det = determinant(a);
+            if (det == 0) singular();
+            for (int i = 0; i < N; ++i) {
+                for (int j = 0; j < N; ++j) {
+                    T sub[N - 1][N - 1]{};
+                    minor(a, i, j, sub);
+                    T cofactor = ((i + j) % 2 == 0 ? T(1) : T(-1)) * determinant(sub);
+                    out[j][i] = cofactor / det;
+                }
+            }
+        } else {
+            T m[N][N]{};
+            copy(a, m);
+            unrolledFor<N>([&](auto i) {
+                unrolledFor<N>([&](auto j) {
+                    out[i][j] = (i == j) ? T(1) : T(0);
+                });
+            });
+            for (int i = 0; i < N; ++i) {
+                int pivot = findPivotRow(m, i);
+                if (m[pivot][i] == 0) singular();
+                if (pivot != i) {
+                    swapRows(m, i, pivot);
+                    swapRows(out, i, pivot);
+                }
+                T pivotValue = m[i][i];
+                unrolledFor<N>([&](auto k) {
+                    m[i][k] /= pivotValue;
+                    out[i][k] /= pivotValue;
+                });
+                for (int r = 0; r < N; ++r) {
+                    if (r == i || m[r][i] == 0) continue;
+                    T factor = m[r][i];
+                    unrolledFor<N>([&](auto k) {
+                        m[r][k] -= factor * m[i][k];
+                        out[r][k] -= factor * out[i][k];
+                    });
+                }
+            }
+        }
+    }
+
+    template<int M, int N, int P>
+    static constexpr void multiply(const T (&a)[M][N], const T (&b)[N][P], T (&out)[M][P]) {
+        unrolledFor<M>([&](auto i) {
+            unrolledFor<P>([&](auto j) {
+                T sum = 0;
+                unrolledFor<N>([&](auto k) {
+                    sum += a[i][k] * b[k][j];
+                });
+                out[i][j] = sum;
+            });
+        });
+    }
+
+    template<int N>
+    static constexpr void cholesky(const T (&a)[N][N], T (&L)[N][N]) {
+        if constexpr (N > StaticForUnrollLimit) {
+            for (int i = 0; i < N; ++i) {
+                for (int j = 0; j < N; ++j) {
+                    L[i][j] = 0;
+                }
+                for (int j = 0; j <= i; ++j) {
+                    T sum = 0;
+                    for (int k = 0; k < j; ++k) {
+                        sum += L[i][k] * L[j][k];
+                    }
+                    if (i == j) {
+                        L[i][i] = ConstexprMath::sqrt(a[i][i] - sum);
+                    } else {
+                        L[i][j] = (a[i][j] - sum) / L[j][j];
+                    }
+                }
+            }
+        } else {
+            staticFor<N>([&](auto i) {
+                staticFor<N>([&](auto j) {
+                    if constexpr (j > i) {
+                        L[i][j] = 0;
+                    } else {
+                        T sum = 0;
+                        staticFor<j>([&](auto k) {
+                            sum += L[i][k] * L[j][k];
+                        });
+                        if constexpr (i == j) {
+                            L[i][i] = ConstexprMath::sqrt(a[i][i] - sum);
+                        } else {
+                            L[i][j] = (a[i][j] - sum) / L[j][j];
+                        }
+                    }
+                });
+            });
+        }
+    }
+
+    // Partial-pivoting Gaussian elimination, mirroring GaussianEliminationSolver
+    template<int N>
+    static constexpr void solve(const T (&a)[N][N], const T (&b)[N][1], T (&x)[N][1]) {
+        T m[N][N]{};
+        T vec[N]{};
+        copy(a, m);
+        for (int i = 0; i < N; ++i) {
+            vec[i] = b[i][0];
+        }
+
+        for (int i = 0; i < N; ++i) {
+            int pivot = findPivotRow(m, i);
+            swapRows(m, i, pivot);
+            std::swap(vec[i], vec[pivot]);
+
+            if (ConstexprMath::abs(m[i][i]) < 1e-9) {
+                throw std::runtime_error("Singular matrix encountered during Gaussian Elimination.");
+            }
+            for (int r = i + 1; r < N; ++r) {
+                T factor = m[r][i] / m[i][i];
+                vec[r] -= factor * vec[i];
+                for (int k = i; k < N; ++k) {
+                    m[r][k] -= factor * m[i][k];
+                }
+            }
+        }
+
+        for (int i = N - 1; i >= 0; --i) {
+            x[i][0] = vec[i];
+            for (int j = i + 1; j < N; ++j) {
+                x[i][0] -= m[i][j] * x[j][0];
+            }
+            x[i][0] /= m[i][i];
+        }
+    }
+
+    // Householder QR with the same sign convention as the Householder policy
+    template<int Rows, int Cols>
+    static constexpr void qr(const T (&a)[Rows][Cols], T (&Q)[Rows][Rows], T (&R)[Rows][Cols]) {
+        for (int i = 0; i < Rows; ++i) {
+            for (int j = 0; j < Rows; ++j) {
+                Q[i][j] = (i == j) ? T(1) : T(0);
+            }
+            for (int j = 0; j < Cols; ++j) {
+                R[i][j] = a[i][j];
+            }
+        }
+
+        for (int k = 0; k < Cols && k < Rows - 1; ++k) {
+            T x[Rows]{};
+            T normX = 0;
+            for (int i = k; i < Rows; ++i) {
+                x[i] = R[i][k];
+                normX += x[i] * x[i];
+            }
+            normX = ConstexprMath::sqrt(normX);
+            if (normX == 0) continue;
+
+            x[k] += (x[k] >= 0 ? normX : -normX);
+            T normV = 0;
+            for (int i = k; i < Rows; ++i) {
+                normV += x[i] * x[i];
+            }
+            normV = ConstexprMath::sqrt(normV);
+            for (int i = k; i < Rows; ++i) {
+                x[i] /= normV;
+            }
+
+            for (int j = k; j < Cols; ++j) {
+                T sum = 0;
+                for (int i = k; i < Rows; ++i) {
+                    sum += x[i] * R[i][j];
+                }
+                for (int i = k; i < Rows; ++i) {
+                    R[i][j] -= 2 * x[i] * sum;
+                }
+            }
+            for (int j = 0; j < Rows; ++j) {
+                T sum = 0;
+                for (int i = k; i < Rows; ++i) {
+                    sum += x[i] * Q[j][i];
+                }
+                for (int i = k; i < Rows; ++i) {
+                    Q[j][i] -= 2 * x[i] * sum;
+                }
+            }
+        }
+    }
+
+private:
+    [[noreturn]] static constexpr void singular() {
+        throw std::runtime_error("Matrix is singular and cannot be inverted.");
+    }
+
+    template<int N>
+    static constexpr void copy(const T (&source)[N][N], T (&destination)[N][N]) {
+        unrolledFor<N>([&](auto i) {
+            unrolledFor<N>([&](auto j) {
+                destination[i][j] = source[i][j];
+            });
+        });
+    }
+
+    template<int N>
+    static constexpr int findPivotRow(const T (&m)[N][N], int col) {
+        int maxRow = col;
+        for (int r = col + 1; r < N; ++r) {
+            if (ConstexprMath::abs(m[r][col]) > ConstexprMath::abs(m[maxRow][col])) {
+                maxRow = r;
+            }
+        }
+        return maxRow;
+    }
+
+    template<int N>
+    static constexpr void swapRows(T (&m)[N][N], int r1, int r2) {
+        unrolledFor<N>([&](auto k) {
+            std::swap(m[r1][k], m[r2][k]);
+        });
+    }
+
+    template<int N>
+    static constexpr void minor(const T (&a)[N][N], int row, int col, T (&out)[N - 1][N - 1]) {
+        for (int i = 0, m = 0; i < N; ++i) {
+            if (i == row) continue;
+            for (int j = 0, n = 0; j < N; ++j) {
+                if (j == col) continue;
+                out[m][n] = a[i][j];
+                n++;
+            }
+            m++;
+        }
+    }
+
+    // 2x2 minors of the top (s) and bottom (c) row pairs of a 4x4 matrix.
+    static constexpr void pairMinors(const T (&a)[4][4], T (&s)[6], T (&c)[6]) {
+        s[0] = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+        s[1] = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+        s[2] = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+        s[3] = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+        s[4] = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+        s[5] = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+        c[5] = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+        c[4] = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+        c[3] = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+        c[2] = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+        c[1] = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+        c[0] = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+    }
+};
+
+#endif // FIXED_SIZE_KERNELS_HPP
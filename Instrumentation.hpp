@@ -0,0 +1,265 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+// Opt-in counters for Matrix methods and policy calls. A policy set turns them on with
+//     using Instrumentation = OperationProfiler;
+// (or by wrapping it in ProfiledPolicies<...>). The default, NoInstrumentation, and any
+// build with MATRIX_DISABLE_INSTRUMENTATION defined, compile every scope down to nothing.
+
+struct OperationStats {
+    std::uint64_t calls = 0;
+    std::uint64_t nanoseconds = 0;
+    double flops = 0;
+    std::uint64_t bytesAllocated = 0;
+    std::uint64_t bytesCopied = 0;
+};
+
+using InstrumentationSnapshot = std::map<std::string, OperationStats, std::less<>>;
+
+// Each thread records into its own shard, so scopes on different threads do not contend;
+// snapshot() and the dump hook merge the shards by name.
+class InstrumentationRegistry {
+public:
+    using DumpHook = std::function<void(const InstrumentationSnapshot&)>;
+
+    static InstrumentationRegistry& instance() {
+        static InstrumentationRegistry registry;
+        return registry;
+    }
+
+    void record(std::string_view name, const OperationStats& delta) {
+        {
+            Shard& shard = localShard();
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.stats.find(name);
+            if (it == shard.stats.end()) {
+                it = shard.stats.emplace(std::string(name), OperationStats{}).first;
+            }
+            add(it->second, delta);
+        }
+        if (hookInstalled.load(std::memory_order_relaxed)) {
+            dumpIfDue();
+        }
+    }
+
+    InstrumentationSnapshot snapshot() const {
+        InstrumentationSnapshot merged;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> shardLock(shard->mutex);
+            for (const auto& [name, entry] : shard->stats) {
+                add(merged[name], entry);
+            }
+        }
+        return merged;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> shardLock(shard->mutex);
+            shard->stats.clear();
+        }
+    }
+
+    // Calls `hook` with a snapshot at most once per `interval`, from whichever thread records next.
+    void setDumpHook(DumpHook hook, std::chrono::milliseconds interval) {
+        std::lock_guard<std::mutex> lock(mutex);
+        dumpHook = std::move(hook);
+        dumpInterval = interval;
+        nextDump.store(now() + std::chrono::nanoseconds(interval).count(), std::memory_order_relaxed);
+        hookInstalled.store(static_cast<bool>(dumpHook), std::memory_order_relaxed);
+    }
+
+    void clearDumpHook() {
+        setDumpHook(nullptr, std::chrono::milliseconds(0));
+    }
+
+    void dumpNow() {
+        DumpHook hook;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            hook = dumpHook;
+            nextDump.store(now() + std::chrono::nanoseconds(dumpInterval).count(), std::memory_order_relaxed);
+        }
+        if (hook) {
+            hook(snapshot());
+        }
+    }
+
+    static void print(std::ostream& os, const InstrumentationSnapshot& snapshot) {
+        os << std::left << std::setw(40) << "operation" << std::right << std::setw(10) << "calls" << std::setw(14) << "time [us]"
+           << std::setw(14) << "MFLOP" << std::setw(14) << "allocated" << std::setw(14) << "copied" << "\n";
+        for (const auto& [name, s] : snapshot) {
+            os << std::left << std::setw(40) << name << std::right << std::setw(10) << s.calls << std::fixed << std::setprecision(1)
+               << std::setw(14) << s.nanoseconds / 1e3 << std::setw(14) << s.flops / 1e6 << std::defaultfloat
+               << std::setw(14) << s.bytesAllocated << std::setw(14) << s.bytesCopied << "\n";
+        }
+    }
+
+private:
+    // Only snapshot() and reset() take a shard's mutex from another thread
+    struct Shard {
+        std::mutex mutex;
+        InstrumentationSnapshot stats;
+    };
+
+    InstrumentationRegistry() = default;
+
+    static void add(OperationStats& total, const OperationStats& delta) {
+        total.calls += delta.calls;
+        total.nanoseconds += delta.nanoseconds;
+        total.flops += delta.flops;
+        total.bytesAllocated += delta.bytesAllocated;
+        total.bytesCopied += delta.bytesCopied;
+    }
+
+    static std::int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Shards outlive their threads, so counts recorded by finished workers are kept
+    Shard& localShard() {
+        thread_local Shard* shard = nullptr;
+        if (shard == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex);
+            shards.push_back(std::make_unique<Shard>());
+            shard = shards.back().get();
+        }
+        return *shard;
+    }
+
+    void dumpIfDue() {
+        if (now() < nextDump.load(std::memory_order_relaxed)) {
+            return;
+        }
+        bool expected = false;
+        if (!dumping.compare_exchange_strong(expected, true)) {
+            return;
+        }
+        dumpNow();
+        dumping.store(false);
+    }
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Shard>> shards;
+    DumpHook dumpHook;
+    std::chrono::milliseconds dumpInterval{0};
+    std::atomic<std::int64_t> nextDump{0};
+    std::atomic<bool> hookInstalled{false};
+    std::atomic<bool> dumping{false};
+};
+
+// Readable name of a policy class, e.g. "Householder<double>".
+template<typename Policy>
+std::string_view policyName() {
+#if defined(__GNUC__) || defined(__clang__)
+    std::string_view signature = __PRETTY_FUNCTION__;
+#else
+    std::string_view signature;
+#endif
+    static const std::string name = [signature] {
+        std::string_view marker = "Policy = ";
+        std::size_t begin = signature.find(marker);
+        if (begin != std::string_view::npos) {
+            begin += marker.size();
+            std::size_t end = signature.find_first_of(";]", begin);
+            return std::string(signature.substr(begin, end - begin));
+        }
+        return std::string(typeid(Policy).name());
+    }();
+    return name;
+}
+
+class NoInstrumentation {
+public:
+    class Scope {
+    public:
+        constexpr Scope(std::string_view, double = 0, int = 0, int = 0) {}
+        constexpr void addBytesAllocated(std::size_t) {}
+        constexpr void addBytesCopied(std::size_t) {}
+    };
+};
+
+#ifdef MATRIX_DISABLE_INSTRUMENTATION
+
+using OperationProfiler = NoInstrumentation;
+
+#else
+
+class OperationProfiler {
+public:
+    // Literal type so Matrix methods can stay constexpr; nothing is recorded during constant evaluation.
+    class Scope {
+    public:
+        constexpr Scope(std::string_view name, double flops = 0, int = 0, int = 0) : name(name), flops(flops) {
+            if (!std::is_constant_evaluated()) {
+                start = now();
+            }
+        }
+
+        constexpr ~Scope() {
+            if (!std::is_constant_evaluated()) {
+                finish();
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        constexpr void addBytesAllocated(std::size_t bytes) {
+            bytesAllocated += bytes;
+        }
+
+        constexpr void addBytesCopied(std::size_t bytes) {
+            bytesCopied += bytes;
+        }
+
+    private:
+        static std::int64_t now() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void finish() {
+            OperationStats delta;
+            delta.calls = 1;
+            delta.nanoseconds = static_cast<std::uint64_t>(now() - start);
+            delta.flops = flops;
+            delta.bytesAllocated = bytesAllocated;
+            delta.bytesCopied = bytesCopied;
+            InstrumentationRegistry::instance().record(name, delta);
+        }
+
+        std::string_view name;
+        double flops = 0;
+        std::int64_t start = 0;
+        std::uint64_t bytesAllocated = 0;
+        std::uint64_t bytesCopied = 0;
+    };
+};
+
+#endif // MATRIX_DISABLE_INSTRUMENTATION
+
+// Any policy set with profiling switched on
+template<typename Base>
+struct ProfiledPolicies : Base {
+    using Instrumentation = OperationProfiler;
+};
+
+#endif // INSTRUMENTATION_HPP
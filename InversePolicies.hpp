@@ -4,10 +4,14 @@
 #include <vector>
 #include <cmath>
 
+#include "Concepts.hpp"
+#include "MatrixView.hpp"
+
 template<typename T>
 class RowReduction {
 public:
-    static std::vector<std::vector<T>> calculate(const std::vector<std::vector<T>>& matrix) {
+    template<RowIndexable<T> Rows>
+    static std::vector<std::vector<T>> calculate(const Rows& matrix) {
         int M = matrix.size();
         int N = matrix[0].size();
 
@@ -71,7 +75,9 @@ private:
 template<typename T>
 class ClassicalAdjoint {
 public:
-    static std::vector<std::vector<T>> calculate(const std::vector<std::vector<T>>& matrix) {
+    template<RowIndexable<T> Rows>
+    static std::vector<std::vector<T>> calculate(const Rows& input) {
+        const auto& matrix = denseRows<T>(input);
         int M = matrix.size();
         int N = matrix[0].size();
 
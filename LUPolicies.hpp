@@ -2,11 +2,20 @@
 #define LU_POLICIES_HPP
 
 #include<tuple>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+
+#include "Concepts.hpp"
+#include "MatrixView.hpp"
+#include "TaskGraph.hpp"
 
 template<typename T>
 class Doolittle {
 public:
-    static std::tuple<std::vector<std::vector<T>>, std::vector<std::vector<T>>, std::vector<T>, std::vector<T>> calculate(const std::vector<std::vector<T>>& matrix) {
+    template<RowIndexable<T> Rows>
+    static std::tuple<std::vector<std::vector<T>>, std::vector<std::vector<T>>, std::vector<T>, std::vector<T>> calculate(const Rows& matrix) {
         int N = matrix.size();
         std::vector<std::vector<T>> L(N, std::vector<T>(N, 0));
         std::vector<std::vector<T>> U(N, std::vector<T>(N, 0));
@@ -45,7 +54,8 @@ public:
 template<typename T>
 class Crout {
 public:
-    static std::tuple<std::vector<std::vector<T>>, std::vector<std::vector<T>>, std::vector<T>, std::vector<T>>  calculate(const std::vector<std::vector<T>>& matrix) {
+    template<RowIndexable<T> Rows>
+    static std::tuple<std::vector<std::vector<T>>, std::vector<std::vector<T>>, std::vector<T>, std::vector<T>>  calculate(const Rows& matrix) {
         int N = matrix.size();
         std::vector<std::vector<T>> L(N, std::vector<T>(N, 0));
         std::vector<std::vector<T>> U(N, std::vector<T>(N, 0));
@@ -84,10 +94,11 @@ public:
 template<typename T>
 class GaussianFullPivoting {
 public:
-    static std::tuple<std::vector<std::vector<T>>, std::vector<std::vector<T>>, std::vector<int>, std::vector<int>> calculate(const std::vector<std::vector<T>>& matrix) {
+    template<RowIndexable<T> Rows>
+    static std::tuple<std::vector<std::vector<T>>, std::vector<std::vector<T>>, std::vector<int>, std::vector<int>> calculate(const Rows& matrix) {
         int N = matrix.size();
         std::vector<std::vector<T>> L(N, std::vector<T>(N, 0));
-        std::vector<std::vector<T>> U = matrix;
+        std::vector<std::vector<T>> U = denseRows<T>(matrix);
         std::vector<int> rowPermutation(N), colPermutation(N);
 
         for (int i = 0; i < N; ++i) {
@@ -131,5 +142,200 @@ public:
     }
 };
 
+// LU with partial pivoting over TileSize x TileSize tiles as a TaskGraph, P A = L U with the
+// row permutation returned like GaussianFullPivoting's. Each step factors the column of tiles
+// on and below the diagonal as one panel (getrf), since the pivot of a column may come from
+// any tile of it; then each tile column right of it takes over the panel's row swaps and is
+// solved with L (trsmLower), and the trailing tiles are updated (gemm) as soon as their
+// operands are final. The swaps of the columns left of the panel are applied at the end.
+// The tile size is clamped to the matrix size and edge tiles are worked on at their real size.
+template<typename T, int TileSize = 128>
+class TiledLU {
+public:
+    template<RowIndexable<T> Rows>
+    static std::tuple<std::vector<std::vector<T>>, std::vector<std::vector<T>>, std::vector<T>, std::vector<T>> calculate(const Rows& matrix) {
+        int n = matrix.size();
+        TileGrid<T> A(matrix, std::min(TileSize, std::max(n, 1)));
+        int tiles = A.tileRows();
+        int ld = A.tileSize();
+        // pivots[k][p]: row of the panel, counted from its top, swapped with row p in step k
+        std::vector<std::vector<int>> pivots(tiles);
+        TaskGraph graph;
+
+        for (int k = 0; k < tiles; ++k) {
+            std::vector<T*> panel;
+            std::vector<TaskGraph::Dependency> panelData;
+            for (int i = k; i < tiles; ++i) {
+                panel.push_back(A.tile(i, k));
+                panelData.push_back(TaskGraph::writes(A.tile(i, k)));
+            }
+            T* Akk = A.tile(k, k);
+            int nk = A.tileHeight(k);
+            int panelRows = n - k * ld;
+            std::vector<int>* stepPivots = &pivots[k];
+            graph.add([=] { getrf(panel, ld, panelRows, nk, *stepPivots); }, panelData);
+            for (int j = k + 1; j < tiles; ++j) {
+                std::vector<T*> column;
+                std::vector<TaskGraph::Dependency> columnData = {TaskGraph::reads(Akk)};
+                for (int i = k; i < tiles; ++i) {
+                    column.push_back(A.tile(i, j));
+                    columnData.push_back(TaskGraph::writes(A.tile(i, j)));
+                }
+                int nj = A.tileWidth(j);
+                graph.add([=] {
+                    swapRows(column, ld, nj, *stepPivots);
+                    trsmLower(Akk, column[0], ld, nk, nj);
+                }, columnData);
+            }
+            for (int i = k + 1; i < tiles; ++i) {
+                for (int j = k + 1; j < tiles; ++j) {
+                    T* Aik = A.tile(i, k);
+                    T* Akj = A.tile(k, j);
+                    T* Aij = A.tile(i, j);
+                    int ni = A.tileHeight(i);
+                    int nj = A.tileWidth(j);
+                    graph.add([=] { gemm(Aik, Akj, Aij, ld, ni, nj, nk); }, {TaskGraph::reads(Aik), TaskGraph::reads(Akj), TaskGraph::writes(Aij)});
+                }
+            }
+        }
+        graph.run();
+
+        std::vector<std::vector<T>> packed = A.toVectorMatrix();
+        int N = packed.size();
+        std::vector<int> permutation(N);
+        for (int i = 0; i < N; ++i) {
+            permutation[i] = i;
+        }
+        for (int k = 0; k < tiles; ++k) {
+            for (int p = 0; p < static_cast<int>(pivots[k].size()); ++p) {
+                int row = k * ld + p;
+                int pivotRow = k * ld + pivots[k][p];
+                if (pivotRow != row) {
+                    std::swap(permutation[row], permutation[pivotRow]);
+                    std::swap_ranges(packed[row].begin(), packed[row].begin() + k * ld, packed[pivotRow].begin());
+                }
+            }
+        }
+
+        std::vector<std::vector<T>> L(N, std::vector<T>(N, 0));
+        std::vector<std::vector<T>> U(N, std::vector<T>(N, 0));
+        std::vector<T> rowPermutation(N), colPermutation(N);
+        for (int i = 0; i < N; ++i) {
+            rowPermutation[i] = permutation[i];
+            colPermutation[i] = i;
+            for (int j = 0; j < i; ++j) {
+                L[i][j] = packed[i][j];
+            }
+            L[i][i] = 1;
+            for (int j = i; j < N; ++j) {
+                U[i][j] = packed[i][j];
+            }
+        }
+        return {L, U, rowPermutation, colPermutation};
+    }
+
+private:
+    // The kernels work on tiles with row stride ld; the sizes are the extents inside the matrix.
+    // A column of tiles is given top to bottom, and its row r lies in tile r / ld.
+
+    static T* row(const std::vector<T*>& column, int ld, int r) {
+        return column[r / ld] + (r % ld) * ld;
+    }
+
+    // P A = L U in place for the rows x n panel A, L unit lower; pivots[p] is the row swapped
+    // with row p before eliminating column p
+    static void getrf(const std::vector<T*>& panel, int ld, int rows, int n, std::vector<int>& pivots) {
+        pivots.assign(n, 0);
+        for (int p = 0; p < n; ++p) {
+            int pivotRow = p;
+            for (int r = p + 1; r < rows; ++r) {
+                if (std::abs(row(panel, ld, r)[p]) > std::abs(row(panel, ld, pivotRow)[p])) {
+                    pivotRow = r;
+                }
+            }
+            pivots[p] = pivotRow;
+            T* top = row(panel, ld, p);
+            if (pivotRow != p) {
+                std::swap_ranges(top, top + n, row(panel, ld, pivotRow));
+            }
+            T pivot = top[p];
+            if (pivot == 0) {
+                throw std::runtime_error("Singular matrix encountered during tiled LU decomposition.");
+            }
+            for (int r = p + 1; r < rows; ++r) {
+                T* current = row(panel, ld, r);
+                T factor = current[p] / pivot;
+                current[p] = factor;
+                for (int j = p + 1; j < n; ++j) {
+                    current[j] -= factor * top[j];
+                }
+            }
+        }
+    }
+
+    // The row swaps of a panel on the column of tiles next to it, cols wide
+    static void swapRows(const std::vector<T*>& column, int ld, int cols, const std::vector<int>& pivots) {
+        for (int p = 0; p < static_cast<int>(pivots.size()); ++p) {
+            if (pivots[p] != p) {
+                T* top = row(column, ld, p);
+                std::swap_ranges(top, top + cols, row(column, ld, pivots[p]));
+            }
+        }
+    }
+
+    // A = L^-1 * A for the n x cols tile A, with the unit lower triangle of the n x n LU
+    static void trsmLower(const T* LU, T* A, int ld, int n, int cols) {
+        for (int p = 0; p < n; ++p) {
+            for (int i = p + 1; i < n; ++i) {
+                T factor = LU[i * ld + p];
+                for (int j = 0; j < cols; ++j) {
+                    A[i * ld + j] -= factor * A[p * ld + j];
+                }
+            }
+        }
+    }
+
+    // C -= A * Bk for the m x k tile A, k x n tile Bk and m x n tile C
+    static void gemm(const T* A, const T* Bk, T* C, int ld, int m, int n, int k) {
+        for (int i = 0; i < m; ++i) {
+            for (int p = 0; p < k; ++p) {
+                T a = A[i * ld + p];
+                for (int j = 0; j < n; ++j) {
+                    C[i * ld + j] -= a * Bk[p * ld + j];
+                }
+            }
+        }
+    }
+};
+
+// Rank-one update of an unpivoted LU factorization in O(n^2) with Bennett's algorithm:
+// afterwards L U equals the old L U plus x y^T, L keeping its unit diagonal. Like Doolittle it
+// does not pivot, so it needs the updated leading minors to be nonsingular; on a zero pivot it
+// throws with the factors partly updated.
+template<typename T>
+class LUUpdate {
+public:
+    static void update(std::vector<std::vector<T>>& L, std::vector<std::vector<T>>& U, std::vector<T> x, std::vector<T> y) {
+        int n = L.size();
+        if (static_cast<int>(U.size()) != n || static_cast<int>(x.size()) != n || static_cast<int>(y.size()) != n) {
+            throw std::invalid_argument("Vector length does not match the factor size.");
+        }
+        for (int i = 0; i < n; ++i) {
+            U[i][i] += x[i] * y[i];
+            if (std::abs(U[i][i]) < 1e-9) {
+                throw std::runtime_error("Zero pivot encountered during LU update.");
+            }
+            y[i] /= U[i][i];
+            for (int j = i + 1; j < n; ++j) {
+                x[j] -= x[i] * L[j][i];
+                L[j][i] += y[i] * x[j];
+            }
+            for (int j = i + 1; j < n; ++j) {
+                U[i][j] += x[i] * y[j];
+                y[j] -= y[i] * U[i][j];
+            }
+        }
+    }
+};
 
 #endif // LU_POLICIES_HPP
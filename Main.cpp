@@ -75,7 +75,7 @@ int main() {
 
     std::cout << "mat3" << mat3 << std::endl;
     std::cout << "Q of mat3" << mat3.qrDecomposition().first << std::endl;
-    std::cout << "QTQ of mat3" << mat3.qrDecomposition().first.transpose() * mat3.qrDecomposition().first << std::endl;
+    std::cout << "QTQ of mat3" << mat3.qrDecomposition().first.transposed() * mat3.qrDecomposition().first << std::endl;
     std::cout << "R of mat3" << mat3.qrDecomposition().second << std::endl;
     std::cout << "Recomposition of mat3" << mat3.qrDecomposition().first * mat3.qrDecomposition().second << std::endl;
 
@@ -83,7 +83,7 @@ int main() {
     Matrix<4, 4, double> mat4(data4);
     std::cout << "mat4" << mat4 << std::endl;
     std::cout << "L of mat4" << mat4.choleskyDecomposition() << std::endl;
-    std::cout << "Recomposition of mat4" << mat4.choleskyDecomposition() * mat4.choleskyDecomposition().transpose() << std::endl;
+    std::cout << "Recomposition of mat4" << mat4.choleskyDecomposition() * mat4.choleskyDecomposition().transposed() << std::endl;
 
     std::cout << "Eigenvalue of mat4 " << mat4.eigenvalueDecomposition() << std::endl;
 
@@ -2,6 +2,10 @@
 #define MATRIX_HPP
 
 #include<tuple>
+#include <future>
+#include <iostream>
+#include <type_traits>
+#include <utility>
 
 #include "DeterminantPolicies.hpp"
 #include "InversePolicies.hpp"
@@ -11,30 +15,64 @@
 #include "CholeskyPolicies.hpp"
 #include "EigenvaluesPolicies.hpp"
 #include "SolvingPolicies.hpp"
+#include "SVDPolicies.hpp"
 #include "Concepts.hpp"
+#include "FixedSizeKernels.hpp"
+#include "PolicyTraits.hpp"
+#include "Workspace.hpp"
+#include "MatrixView.hpp"
+#include "MatrixStorage.hpp"
+#include "Transpose.hpp"
+#include "Executor.hpp"
 
 //Struct for Policies
 template<typename T>
 struct MatrixPolicies {
-    using DeterminantPolicy = LaplaceExpansion<T>;
+    // Integer determinants stay exact under fraction-free elimination; Laplace is O(n!)
+    using DeterminantPolicy = std::conditional_t<std::is_integral_v<T>, BareissDeterminant<T>, LaplaceExpansion<T>>;
     using InversionPolicy = ClassicalAdjoint<T>;
     using MultiplicationPolicy = StandardMatrixMultiplication<T>;
     using LUPolicy = Doolittle<T>;
     using QRPolicy = Householder<T>;
     using CholeskyPolicy = Cholesky<T>;
+    using CholeskyUpdatePolicy = CholeskyUpdate<T>;
+    using LUUpdatePolicy = LUUpdate<T>;
     using EigenvaluePolicy = PowerIteration<T>;
-    using SolvingPolicy = GaussianEliminationSolver<T>;
+    using SVDPolicy = OneSidedJacobiSVD<T>;
+    using LowRankSVDPolicy = RandomizedSVD<T>;
+    using SolvingPolicy = AutoSolver<T>;
     using SolvingDecomposePolicy = QRSolver<T>;
     using SolvingIterativePolicy = GaussSeidelSolver<T>;
+    using ExactSolvingPolicy = BareissSolver<T>;
+    using TransposedMultiplicationPolicy = TransposedMultiplication<T>;
+    using SymmetricRankKPolicy = SymmetricRankK<T>;
+    using Instrumentation = NoInstrumentation;
+    static constexpr int FixedSizeKernelLimit = 8;
+    static constexpr std::size_t HeapStorageBytes = 16384;
+
+    // Scratch memory for policy temporaries; nullptr uses a thread-local arena
+    static std::pmr::memory_resource* workspaceResource() {
+        return nullptr;
+    }
+
+    // Thread pool for parallel policies and the *Async methods; nullptr uses the library-wide
+    // MatrixExecutor::shared(). Return a static MatrixExecutor to choose the thread count and
+    // CPU affinity.
+    static MatrixExecutor* executor() {
+        return nullptr;
+    }
 };
 
+template <int M, int N, typename T, typename Policies>
+class TransposedMatrix;
+
 template <int M, int N, typename T, typename Policies = MatrixPolicies<T>>
 class Matrix {
 public:
     
 //====================CONSTRUCTORS====================================
 
-    Matrix() {
+    constexpr Matrix() {
         for (int i = 0; i < M; ++i) {
             for (int j = 0; j < N; ++j) {
                 data[i][j] = T();
@@ -42,7 +80,7 @@ public:
         }
     }
 
-    Matrix(const T (&initData)[M][N]) {
+    constexpr Matrix(const T (&initData)[M][N]) {
         for (int i = 0; i < M; ++i) {
             for (int j = 0; j < N; ++j) {
                 data[i][j] = initData[i][j];
@@ -50,7 +88,9 @@ public:
         }
     }
 
-    Matrix(const std::vector<std::vector<T>>& initData) {
+    constexpr Matrix(const std::vector<std::vector<T>>& initData) {
+        Scope scope("Matrix::fromVectorMatrix", 0, M, N);
+        scope.addBytesCopied(M * N * sizeof(T));
         if (initData.size() != M || (initData.size() > 0 && initData[0].size() != N)) {
             throw std::invalid_argument("Invalid dimensions for matrix initialization.");
         }
@@ -62,7 +102,9 @@ public:
         }
     }
 
-    Matrix(const std::vector<T>& initData) {
+    constexpr Matrix(const std::vector<T>& initData) {
+        Scope scope("Matrix::fromVector", 0, M, N);
+        scope.addBytesCopied(M * sizeof(T));
         if (initData.size() != M || N != 1) {
             throw std::invalid_argument("Invalid dimensions for matrix initialization.");
         }
@@ -72,21 +114,65 @@ public:
         }
     }
 
-//====================================METHODS=======================================================
+    // Copies from any row-indexable source, e.g. a view or block of another matrix
+    template<RowIndexable<T> Rows>
+        requires (!std::is_same_v<Rows, std::vector<std::vector<T>>>)
+    Matrix(const Rows& initData) {
+        Scope scope("Matrix::fromRows", 0, M, N);
+        scope.addBytesCopied(M * N * sizeof(T));
+        if (initData.size() != M || (initData.size() > 0 && initData[0].size() != N)) {
+            throw std::invalid_argument("Invalid dimensions for matrix initialization.");
+        }
 
-    // Method to transpose the matrix
-    Matrix<N, M, T> transpose() const {
-        Matrix<N, M, T> result;
         for (int i = 0; i < M; ++i) {
             for (int j = 0; j < N; ++j) {
-                result.data[j][i] = this->data[i][j];
+                data[i][j] = initData[i][j];
+            }
+        }
+    }
+
+//====================================METHODS=======================================================
+
+    // Method to transpose the matrix
+    constexpr Matrix<N, M, T, Policies> transpose() const {
+        Scope scope("Matrix::transpose", 0, M, N);
+        scope.addBytesCopied(M * N * sizeof(T));
+        Matrix<N, M, T, Policies> result;
+        if (std::is_constant_evaluated()) {
+            for (int i = 0; i < M; ++i) {
+                for (int j = 0; j < N; ++j) {
+                    result.data[j][i] = this->data[i][j];
+                }
             }
+        } else {
+            onPolicyExecutor([&] { TransposeKernels<T>::outOfPlace(&data[0][0], N, &result.data[0][0], M, M, N); });
         }
         return result;
     }
 
+    // Method for a lazy transpose that products read in place; it refers to this matrix,
+    // so it must not outlive it
+    constexpr TransposedMatrix<M, N, T, Policies> transposed() const {
+        return TransposedMatrix<M, N, T, Policies>(*this);
+    }
+
+    // Method to transpose a square matrix without allocating
+    constexpr Matrix& transposeInPlace() requires SquareMatrix<M, N, T> {
+        Scope scope("Matrix::transposeInPlace", 0, M, N);
+        if (std::is_constant_evaluated()) {
+            for (int i = 0; i < M; ++i) {
+                for (int j = i + 1; j < N; ++j) {
+                    std::swap(data[i][j], data[j][i]);
+                }
+            }
+        } else {
+            onPolicyExecutor([&] { TransposeKernels<T>::inPlace(&data[0][0], N, M); });
+        }
+        return *this;
+    }
+
     // Method to negate the matrix
-    Matrix<M, N, T> negate() const requires Negatable<T> {
+    constexpr Matrix<M, N, T> negate() const requires Negatable<T> {
         Matrix<M, N, T> result;
         for (int i = 0; i < M; ++i) {
             for (int j = 0; j < N; ++j) {
@@ -98,6 +184,9 @@ public:
 
     // Method to convert the fixed-size array to a vector of vectors
     std::vector<std::vector<T>> toVectorMatrix() const {
+        Scope scope("Matrix::toVectorMatrix", 0, M, N);
+        scope.addBytesAllocated(M * sizeof(std::vector<T>) + M * N * sizeof(T));
+        scope.addBytesCopied(M * N * sizeof(T));
         std::vector<std::vector<T>> vecMatrix(M, std::vector<T>(N));
         for (int i = 0; i < M; ++i) {
             for (int j = 0; j < N; ++j) {
@@ -107,30 +196,243 @@ public:
         return vecMatrix;
     }
 
+    // Method to convert the matrix to a flat vector in row-major order
+    std::vector<T> toVector() const {
+        Scope scope("Matrix::toVector", 0, M, N);
+        scope.addBytesAllocated(M * N * sizeof(T));
+        scope.addBytesCopied(M * N * sizeof(T));
+        std::vector<T> vec;
+        vec.reserve(M * N);
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                vec.push_back(data[i][j]);
+            }
+        }
+        return vec;
+    }
+
+    // Method for viewing the whole matrix without copying
+    ConstMatrixView<T> view() const {
+        return ConstMatrixView<T>(&data[0][0], M, N, N);
+    }
+
+    MatrixView<T> view() {
+        return MatrixView<T>(&data[0][0], M, N, N);
+    }
+
+    // Method for viewing the R x C block whose top-left element is (i, j)
+    template<int R, int C>
+    ConstMatrixView<T> block(int i, int j) const {
+        static_assert(R > 0 && C > 0 && R <= M && C <= N, "Block does not fit in the matrix.");
+        return block(i, j, R, C);
+    }
+
+    template<int R, int C>
+    MatrixView<T> block(int i, int j) {
+        static_assert(R > 0 && C > 0 && R <= M && C <= N, "Block does not fit in the matrix.");
+        return block(i, j, R, C);
+    }
+
+    // Method for viewing a block whose extents are only known at runtime
+    ConstMatrixView<T> block(int i, int j, int rows, int cols) const {
+        if (i < 0 || j < 0 || rows < 0 || cols < 0) {
+            throw std::out_of_range("Block exceeds the bounds of the view.");
+        }
+        return view().block(i, j, rows, cols);
+    }
+
+    MatrixView<T> block(int i, int j, int rows, int cols) {
+        if (i < 0 || j < 0 || rows < 0 || cols < 0) {
+            throw std::out_of_range("Block exceeds the bounds of the view.");
+        }
+        return view().block(i, j, rows, cols);
+    }
+
+    // Method for viewing a single row as a 1 x N block
+    ConstMatrixView<T> row(int i) const {
+        return block(i, 0, 1, N);
+    }
+
+    MatrixView<T> row(int i) {
+        return block(i, 0, 1, N);
+    }
+
+    // Method for viewing a single column as an M x 1 block
+    ConstMatrixView<T> col(int j) const {
+        return block(0, j, M, 1);
+    }
+
+    MatrixView<T> col(int j) {
+        return block(0, j, M, 1);
+    }
+
     // Method for determinant calculation
-    T determinant() const requires SquareMatrix<M, N, T> && Arithmetic<T>{
-        auto vecMatrix = toVectorMatrix();
-        return Policies::DeterminantPolicy::calculate(vecMatrix);
+    constexpr T determinant() const requires SquareMatrix<M, N, T> && Arithmetic<T>{
+        Scope scope("Matrix::determinant", luFlops, M, N);
+        if constexpr (fitsFixedSizeKernels<M, N> && FixedSizeKernels<T>::template supportsDeterminant<M>) {
+            return FixedSizeKernels<T>::determinant(data.array());
+        }
+        if (std::is_constant_evaluated()) {
+            return FixedSizeKernels<T>::determinant(data.array());
+        }
+        return invokePolicy<typename Policies::DeterminantPolicy>(luFlops, [&] {
+            return Policies::DeterminantPolicy::calculate(view());
+        });
     }
 
     // Method for inverting a matrix
-    Matrix<M, N, T> inverse() const requires SquareMatrix<M, N, T> && Arithmetic<T> {
-        auto vecMatrix = toVectorMatrix();
-        auto result = Policies::InversionPolicy::calculate(vecMatrix);
+    constexpr Matrix<M, N, T, Policies> inverse() const requires SquareMatrix<M, N, T> && Arithmetic<T> {
+        Scope scope("Matrix::inverse", 3 * luFlops, M, N);
+        if constexpr (fitsFixedSizeKernels<M, N> && FixedSizeKernels<T>::template supportsInverse<M>) {
+            Matrix<M, N, T, Policies> result;
+            FixedSizeKernels<T>::inverse(data.array(), result.data.array());
+            return result;
+        }
+        if (std::is_constant_evaluated()) {
+            Matrix<M, N, T, Policies> result;
+            FixedSizeKernels<T>::inverse(data.array(), result.data.array());
+            return result;
+        }
+        auto result = invokePolicy<typename Policies::InversionPolicy>(3 * luFlops, [&] {
+            return Policies::InversionPolicy::calculate(view());
+        });
         return Matrix<M, N, T, Policies>(result);
     }
 
     // Method for matrix multiplication 
     template<int P>
-    Matrix<M, P, T, Policies> multiply(const Matrix<N, P, T, Policies>& other) const requires Arithmetic<T> {
-        auto vecMatrix1 = toVectorMatrix();
-        auto vecMatrix2 = other.toVectorMatrix();
-        auto result = Policies::MultiplicationPolicy::calculate(vecMatrix1, vecMatrix2);
+    constexpr Matrix<M, P, T, Policies> multiply(const Matrix<N, P, T, Policies>& other) const requires Arithmetic<T> {
+        constexpr double flops = 2.0 * M * N * P;
+        Scope scope("Matrix::multiply", flops, M, N);
+        if ((fitsFixedSizeKernels<M, N> && fitsFixedSizeKernels<N, P>) || std::is_constant_evaluated()) {
+            Matrix<M, P, T, Policies> result;
+            FixedSizeKernels<T>::multiply(data.array(), other.data.array(), result.data.array());
+            return result;
+        }
+        auto result = invokePolicy<typename Policies::MultiplicationPolicy>(flops, [&] {
+            return Policies::MultiplicationPolicy::calculate(view(), other.view());
+        });
         return Matrix<M, P, T, Policies>(result);
     }
 
+    // Method for multiplying by an N x P view or block without copying it into a Matrix first
+    template<int P, RowIndexable<T> View>
+    Matrix<M, P, T, Policies> multiply(const View& other) const requires Arithmetic<T> {
+        constexpr double flops = 2.0 * M * N * P;
+        Scope scope("Matrix::multiply", flops, M, N);
+        checkViewShape(other, N, P);
+        auto result = invokePolicy<typename Policies::MultiplicationPolicy>(flops, [&] {
+            return Policies::MultiplicationPolicy::calculate(view(), other);
+        });
+        return Matrix<M, P, T, Policies>(result);
+    }
+
+    // Method for the in-place update this += alpha * other, without a temporary for alpha * other
+    constexpr Matrix& addScaled(T alpha, const Matrix& other) requires Arithmetic<T> {
+        Scope scope("Matrix::addScaled", 2.0 * M * N, M, N);
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                data[i][j] = data[i][j] + alpha * other.data[i][j];
+            }
+        }
+        return *this;
+    }
+
+    // Method for multiplying by a lazily transposed matrix, this * B^T
+    template<int P>
+    constexpr Matrix<M, P, T, Policies> multiply(const TransposedMatrix<P, N, T, Policies>& other) const requires Arithmetic<T> {
+        constexpr double flops = 2.0 * M * N * P;
+        using Policy = typename PolicyTransposedMultiplication<Policies>::type;
+        if constexpr (std::is_void_v<Policy>) {
+            return multiply(other.materialize());
+        } else {
+            if ((fitsFixedSizeKernels<M, N> && fitsFixedSizeKernels<N, P>) || std::is_constant_evaluated()) {
+                return multiply(other.materialize());
+            }
+            Scope scope("Matrix::multiply", flops, M, N);
+            auto result = invokePolicy<Policy>(flops, [&] {
+                return Policy::nt(view(), other.source().view());
+            });
+            return Matrix<M, P, T, Policies>(result);
+        }
+    }
+
+    // Method for multiplying the transpose of this matrix without forming it, this^T * B
+    template<int P>
+    constexpr Matrix<N, P, T, Policies> transposeMultiply(const Matrix<M, P, T, Policies>& other) const requires Arithmetic<T> {
+        constexpr double flops = 2.0 * M * N * P;
+        using Policy = typename PolicyTransposedMultiplication<Policies>::type;
+        if constexpr (std::is_void_v<Policy>) {
+            return transpose().multiply(other);
+        } else {
+            if ((fitsFixedSizeKernels<N, M> && fitsFixedSizeKernels<M, P>) || std::is_constant_evaluated()) {
+                return transpose().multiply(other);
+            }
+            Scope scope("Matrix::multiply", flops, N, M);
+            auto result = invokePolicy<Policy>(flops, [&] {
+                return Policy::tn(view(), other.view());
+            });
+            return Matrix<N, P, T, Policies>(result);
+        }
+    }
+
+    // this^T * B^T
+    template<int P>
+    constexpr Matrix<N, P, T, Policies> transposeMultiply(const TransposedMatrix<P, M, T, Policies>& other) const requires Arithmetic<T> {
+        constexpr double flops = 2.0 * M * N * P;
+        using Policy = typename PolicyTransposedMultiplication<Policies>::type;
+        if constexpr (std::is_void_v<Policy>) {
+            return transpose().multiply(other.materialize());
+        } else {
+            if ((fitsFixedSizeKernels<N, M> && fitsFixedSizeKernels<M, P>) || std::is_constant_evaluated()) {
+                return transpose().multiply(other.materialize());
+            }
+            Scope scope("Matrix::multiply", flops, N, M);
+            auto result = invokePolicy<Policy>(flops, [&] {
+                return Policy::tt(view(), other.source().view());
+            });
+            return Matrix<N, P, T, Policies>(result);
+        }
+    }
+
+    // Method for the Gram matrix A^T * A; it is symmetric, so only one triangle is computed
+    constexpr Matrix<N, N, T, Policies> gram() const requires Arithmetic<T> {
+        constexpr double flops = 1.0 * M * N * N;
+        using Policy = typename PolicySymmetricRankK<Policies>::type;
+        if constexpr (std::is_void_v<Policy>) {
+            return transposeMultiply(*this);
+        } else {
+            if (fitsFixedSizeKernels<N, M> || std::is_constant_evaluated()) {
+                return transposeMultiply(*this);
+            }
+            Scope scope("Matrix::gram", flops, M, N);
+            auto result = invokePolicy<Policy>(flops, [&] {
+                return Policy::ata(view());
+            });
+            return Matrix<N, N, T, Policies>(result);
+        }
+    }
+
+    // Method for the outer Gram matrix A * A^T
+    constexpr Matrix<M, M, T, Policies> outerGram() const requires Arithmetic<T> {
+        constexpr double flops = 1.0 * M * M * N;
+        using Policy = typename PolicySymmetricRankK<Policies>::type;
+        if constexpr (std::is_void_v<Policy>) {
+            return multiply(transposed());
+        } else {
+            if (fitsFixedSizeKernels<M, N> || std::is_constant_evaluated()) {
+                return multiply(transposed());
+            }
+            Scope scope("Matrix::outerGram", flops, M, N);
+            auto result = invokePolicy<Policy>(flops, [&] {
+                return Policy::aat(view());
+            });
+            return Matrix<M, M, T, Policies>(result);
+        }
+    }
+
     // Method for element-wise multiplication
-    Matrix<M, N, T> elementWiseMultiply(const Matrix<M, N, T>& other) const requires Multiplicable<T> {
+    constexpr Matrix<M, N, T> elementWiseMultiply(const Matrix<M, N, T>& other) const requires Multiplicable<T> {
         Matrix<M, N, T> result;
         for (int i = 0; i < M; ++i) {
             for (int j = 0; j < N; ++j) {
@@ -141,7 +443,7 @@ public:
     }
 
     // Method for calculating trace
-    T trace() const requires SquareMatrix<M, N, T> {
+    constexpr T trace() const requires SquareMatrix<M, N, T> {
 
         T traceSum = 0;
         for (int i = 0; i < M; ++i) {
@@ -152,68 +454,267 @@ public:
 
     // Method for LU decomposition
     std::pair<Matrix<M, N, T, Policies>, Matrix<M, N, T, Policies>> luDecomposition() const requires SquareMatrix<M, N, T> && Arithmetic<T>  {
-        auto vecMatrix = toVectorMatrix();
-        auto [L, U, row, column] = Policies::LUPolicy::calculate(vecMatrix);
+        Scope scope("Matrix::luDecomposition", luFlops, M, N);
+        auto [L, U, row, column] = invokePolicy<typename Policies::LUPolicy>(luFlops, [&] {
+            return Policies::LUPolicy::calculate(view());
+        });
         return {Matrix<M, N, T, Policies>(L), Matrix<M, N, T, Policies>(U)};
     }
 
+    // Method for the rank-one update of an unpivoted LU factorization in place, as returned by
+    // luDecomposition() with the default policy: afterwards L U equals the old L U plus u v^T
+    static void luUpdate(std::pair<Matrix<M, N, T, Policies>, Matrix<M, N, T, Policies>>& factors, const Matrix<M, 1, T, Policies>& u, const Matrix<M, 1, T, Policies>& v) requires SquareMatrix<M, N, T> && Arithmetic<T> {
+        Scope scope("Matrix::luUpdate", updateFlops, M, N);
+        auto L = factors.first.toVectorMatrix();
+        auto U = factors.second.toVectorMatrix();
+        invokePolicy<typename Policies::LUUpdatePolicy>(updateFlops, [&] {
+            Policies::LUUpdatePolicy::update(L, U, u.toVector(), v.toVector());
+        });
+        factors = {Matrix<M, N, T, Policies>(L), Matrix<M, N, T, Policies>(U)};
+    }
+
     // Method for QR decomposition
-    std::pair<Matrix<M, N, T, Policies>, Matrix<N, N, T, Policies>> qrDecomposition() const requires Arithmetic<T> {
-        auto vecMatrix = toVectorMatrix();
-        auto [Q, R] = Policies::QRPolicy::calculate(vecMatrix);
+    constexpr std::pair<Matrix<M, N, T, Policies>, Matrix<N, N, T, Policies>> qrDecomposition() const requires Arithmetic<T> {
+        Scope scope("Matrix::qrDecomposition", qrFlops, M, N);
+        if (std::is_constant_evaluated()) {
+            T Q[M][M]{};
+            T R[M][N]{};
+            FixedSizeKernels<T>::qr(data.array(), Q, R);
+            Matrix<M, N, T, Policies> thinQ;
+            Matrix<N, N, T, Policies> thinR;
+            for (int i = 0; i < M; ++i) {
+                for (int j = 0; j < N && j < M; ++j) {
+                    thinQ.data[i][j] = Q[i][j];
+                }
+            }
+            for (int i = 0; i < N && i < M; ++i) {
+                for (int j = 0; j < N; ++j) {
+                    thinR.data[i][j] = R[i][j];
+                }
+            }
+            return {thinQ, thinR};
+        }
+        auto [Q, R] = invokePolicy<typename Policies::QRPolicy>(qrFlops, [&] {
+            return Policies::QRPolicy::calculate(view());
+        });
         return {Matrix<M, N, T, Policies>(Q), Matrix<N, N, T, Policies>(R)};
     }
 
     // Method for Cholesky Decomposition
-    Matrix<M, M, T, Policies> choleskyDecomposition() const requires SquareMatrix<M, N, T> && Arithmetic<T> {
-        auto vecMatrix = toVectorMatrix();  
-        auto L = Policies::CholeskyPolicy::calculate(vecMatrix);
+    constexpr Matrix<M, M, T, Policies> choleskyDecomposition() const requires SquareMatrix<M, N, T> && Arithmetic<T> {
+        Scope scope("Matrix::choleskyDecomposition", luFlops / 2, M, N);
+        if constexpr (fitsFixedSizeKernels<M, N> && FixedSizeKernels<T>::supportsCholesky) {
+            Matrix<M, M, T, Policies> L;
+            FixedSizeKernels<T>::cholesky(data.array(), L.data.array());
+            return L;
+        }
+        if (std::is_constant_evaluated()) {
+            Matrix<M, M, T, Policies> L;
+            FixedSizeKernels<T>::cholesky(data.array(), L.data.array());
+            return L;
+        }
+        auto L = invokePolicy<typename Policies::CholeskyPolicy>(luFlops / 2, [&] {
+            return Policies::CholeskyPolicy::calculate(view());
+        });
         return Matrix<M, M, T, Policies>(L);
     }
 
+    // Method for updating a Cholesky factor in place in O(K * M^2): called on L, afterwards
+    // L L^T equals the old L L^T plus V V^T
+    template<int K>
+    void choleskyUpdate(const Matrix<M, K, T, Policies>& V) requires SquareMatrix<M, N, T> && Arithmetic<T> {
+        modifyCholesky(V, false);
+    }
+
+    // Method for downdating a Cholesky factor in place: afterwards L L^T equals the old L L^T
+    // minus V V^T. Throws and leaves L unchanged if the result would not be positive definite.
+    template<int K>
+    void choleskyDowndate(const Matrix<M, K, T, Policies>& V) requires SquareMatrix<M, N, T> && Arithmetic<T> {
+        modifyCholesky(V, true);
+    }
+
+    // Method for the full SVD: U (M x K), the K = min(M, N) singular values in descending order and V (N x K)
+    std::tuple<Matrix<M, std::min(M, N), T, Policies>, Matrix<std::min(M, N), 1, T, Policies>, Matrix<N, std::min(M, N), T, Policies>> svd() const requires Arithmetic<T> {
+        constexpr int K = std::min(M, N);
+        Scope scope("Matrix::svd", svdFlops, M, N);
+        auto [U, sigma, V] = invokePolicy<typename Policies::SVDPolicy>(svdFlops, [&] {
+            return Policies::SVDPolicy::calculate(view());
+        });
+        return {Matrix<M, K, T, Policies>(U), Matrix<K, 1, T, Policies>(sigma), Matrix<N, K, T, Policies>(V)};
+    }
+
+    // Method for the singular values alone, in descending order
+    Matrix<std::min(M, N), 1, T, Policies> singularValues() const requires Arithmetic<T> {
+        Scope scope("Matrix::singularValues", svdFlops / 2, M, N);
+        auto sigma = invokePolicy<typename Policies::SVDPolicy>(svdFlops / 2, [&] {
+            return Policies::SVDPolicy::singularValues(view());
+        });
+        return Matrix<std::min(M, N), 1, T, Policies>(sigma);
+    }
+
+    // Method for the Moore-Penrose pseudoinverse from the SVD; a negative tolerance picks max(M, N) * eps * sigma_max
+    Matrix<N, M, T, Policies> pseudoInverse(T tolerance = T(-1)) const requires Arithmetic<T> {
+        Scope scope("Matrix::pseudoInverse", svdFlops, M, N);
+        auto result = invokePolicy<typename Policies::SVDPolicy>(svdFlops, [&] {
+            return Policies::SVDPolicy::pseudoInverse(view(), tolerance);
+        });
+        return Matrix<N, M, T, Policies>(result);
+    }
+
+    // Method for the numerical rank: singular values above the pseudoinverse tolerance
+    int rank(T tolerance = T(-1)) const requires Arithmetic<T> {
+        Scope scope("Matrix::rank", svdFlops / 2, M, N);
+        return invokePolicy<typename Policies::SVDPolicy>(svdFlops / 2, [&] {
+            return Policies::SVDPolicy::rank(view(), tolerance);
+        });
+    }
+
+    // Method for the truncated SVD of rank K: U (M x K), the K largest singular values and V (N x K)
+    template<int K>
+    std::tuple<Matrix<M, K, T, Policies>, Matrix<K, 1, T, Policies>, Matrix<N, K, T, Policies>> lowRankSVD(int powerIterations = 1) const requires Arithmetic<T> && (K >= 1 && K <= M && K <= N) {
+        constexpr double flops = 4.0 * M * N * K;
+        Scope scope("Matrix::lowRankSVD", flops * (1 + powerIterations), M, N);
+        auto [U, sigma, V] = invokePolicy<typename Policies::LowRankSVDPolicy>(flops * (1 + powerIterations), [&] {
+            return Policies::LowRankSVDPolicy::calculate(view(), K, powerIterations);
+        });
+        return {Matrix<M, K, T, Policies>(U), Matrix<K, 1, T, Policies>(sigma), Matrix<N, K, T, Policies>(V)};
+    }
+
+    // Method for the rank-K approximation U * diag(sigma) * V^T from lowRankSVD
+    template<int K>
+    Matrix<M, N, T, Policies> lowRankApproximation(int powerIterations = 1) const requires Arithmetic<T> && (K >= 1 && K <= M && K <= N) {
+        auto [U, sigma, V] = lowRankSVD<K>(powerIterations);
+        for (int i = 0; i < M; ++i) {
+            for (int k = 0; k < K; ++k) {
+                U(i, k) *= sigma(k, 0);
+            }
+        }
+        return U.multiply(V.transpose());
+    }
+
     // Method for computing eigenvalue decomposition
     T eigenvalueDecomposition() const requires SquareMatrix<M, N, T> && Arithmetic<T> && ComparableWithTolerance<T>{
-        auto vecMatrix = toVectorMatrix();
-        auto [e, eigenvalues] = Policies::EigenvaluePolicy::calculate(vecMatrix);
+        Scope scope("Matrix::eigenvalueDecomposition", 0, M, N);
+        auto [e, eigenvalues] = invokePolicy<typename Policies::EigenvaluePolicy>(0, [&] {
+            return Policies::EigenvaluePolicy::calculate(view());
+        });
         
         return e;
     }
 
-    // Method for gaussian solving
-    Matrix<M, 1, T, Policies> solve(const Matrix<M, 1, T, Policies>& b) const requires Arithmetic<T> {
-        auto A = this->toVectorMatrix();
-        auto vecB = b.toVectorMatrix();
-        auto solution = Policies::SolvingPolicy::solve(A, vecB[0]);
+    // Method for solving, by default with the structure-detecting AutoSolver
+    constexpr Matrix<M, 1, T, Policies> solve(const Matrix<M, 1, T, Policies>& b) const requires Arithmetic<T> {
+        Scope scope("Matrix::solve", solveFlops, M, N);
+        if constexpr (M == N) {
+            if (std::is_constant_evaluated()) {
+                Matrix<M, 1, T, Policies> x;
+                FixedSizeKernels<T>::solve(data.array(), b.data.array(), x.data.array());
+                return x;
+            }
+        }
+        auto vecB = b.toVector();
+        auto solution = invokePolicy<typename Policies::SolvingPolicy>(solveFlops, [&] {
+            return Policies::SolvingPolicy::solve(view(), vecB);
+        });
+        return Matrix<M, 1, T, Policies>(solution);
+    }
+
+    // Method for solving with a right-hand side taken from an M x 1 view, e.g. a column of another matrix
+    template<RowIndexable<T> View>
+    Matrix<M, 1, T, Policies> solve(const View& b) const requires Arithmetic<T> {
+        Scope scope("Matrix::solve", solveFlops, M, N);
+        checkViewShape(b, M, 1);
+        std::vector<T> vecB(M);
+        for (int i = 0; i < M; ++i) {
+            vecB[i] = b[i][0];
+        }
+        auto solution = invokePolicy<typename Policies::SolvingPolicy>(solveFlops, [&] {
+            return Policies::SolvingPolicy::solve(view(), vecB);
+        });
         return Matrix<M, 1, T, Policies>(solution);
     }
 
     // Method for decomposition-based solving
     Matrix<M, 1, T, Policies> solveWithDecompose(const Matrix<M, 1, T, Policies>& b) const requires Arithmetic<T> {
-        auto A = toVectorMatrix();
-        auto vecB = b.toVectorMatrix();
-        auto x = Policies::SolvingDecomposePolicy::solve(A, vecB[0]);
+        Scope scope("Matrix::solveWithDecompose", solveFlops, M, N);
+        auto vecB = b.toVector();
+        auto x = invokePolicy<typename Policies::SolvingDecomposePolicy>(solveFlops, [&] {
+            return Policies::SolvingDecomposePolicy::solve(view(), vecB);
+        });
         return Matrix<M, 1, T, Policies>(x);
     }
 
+    // Method for the exact solution of an integer system, as fractions
+    Matrix<M, 1, Rational<T>> solveExact(const Matrix<M, 1, T, Policies>& b) const requires SquareMatrix<M, N, T> && ExactInteger<T> {
+        Scope scope("Matrix::solveExact", solveFlops, M, N);
+        auto vecB = b.toVector();
+        auto x = invokePolicy<typename Policies::ExactSolvingPolicy>(solveFlops, [&] {
+            return Policies::ExactSolvingPolicy::solve(view(), vecB);
+        });
+        return Matrix<M, 1, Rational<T>>(x);
+    }
+
     // Method for iterative solving
     Matrix<M, 1, T, Policies> solveIteratively(const Matrix<M, 1, T, Policies>& b, T tolerance = 1e-7, int maxIterations = 1000) const requires Arithmetic<T> && ComparableWithTolerance<T>{
-        auto A = toVectorMatrix();
-        auto vecB = b.toVectorMatrix();
-        auto solution = Policies::SolvingIterativePolicy::solve(A, vecB[0], tolerance, maxIterations);
+        Scope scope("Matrix::solveIteratively", 0, M, N);
+        auto vecB = b.toVector();
+        auto solution = invokePolicy<typename Policies::SolvingIterativePolicy>(0, [&] {
+            return Policies::SolvingIterativePolicy::solve(view(), vecB, tolerance, maxIterations);
+        });
         return Matrix<M, 1, T, Policies>(solution);
     }
 
     // Method for QR decomposition
     Matrix<M, N, T, Policies> ortogonalize() const requires Arithmetic<T> {
-        auto vecMatrix = toVectorMatrix();
-        auto [Q, R] = Policies::QRPolicy::calculate(vecMatrix);
+        Scope scope("Matrix::ortogonalize", qrFlops, M, N);
+        auto [Q, R] = invokePolicy<typename Policies::QRPolicy>(qrFlops, [&] {
+            return Policies::QRPolicy::calculate(view());
+        });
         return Matrix<M, N, T, Policies>(Q);
     }
 
+    //=================================ASYNCHRONOUS METHODS==========================================================================
+    // Each runs the method of the same name on the policy set's executor against a copy of the
+    // operands, so the caller's matrices may change or go away while it runs. A cancelled token
+    // makes a task that has not started yet finish with OperationCancelled.
+
+    template<int P>
+    std::future<Matrix<M, P, T, Policies>> multiplyAsync(const Matrix<N, P, T, Policies>& other, CancellationToken token = {}) const requires Arithmetic<T> {
+        return runAsync([self = *this, other] { return self.multiply(other); }, token);
+    }
+
+    std::future<T> determinantAsync(CancellationToken token = {}) const requires SquareMatrix<M, N, T> && Arithmetic<T> {
+        return runAsync([self = *this] { return self.determinant(); }, token);
+    }
+
+    std::future<Matrix<M, N, T, Policies>> inverseAsync(CancellationToken token = {}) const requires SquareMatrix<M, N, T> && Arithmetic<T> {
+        return runAsync([self = *this] { return self.inverse(); }, token);
+    }
+
+    std::future<std::pair<Matrix<M, N, T, Policies>, Matrix<M, N, T, Policies>>> luDecompositionAsync(CancellationToken token = {}) const requires SquareMatrix<M, N, T> && Arithmetic<T> {
+        return runAsync([self = *this] { return self.luDecomposition(); }, token);
+    }
+
+    std::future<std::pair<Matrix<M, N, T, Policies>, Matrix<N, N, T, Policies>>> qrDecompositionAsync(CancellationToken token = {}) const requires Arithmetic<T> {
+        return runAsync([self = *this] { return self.qrDecomposition(); }, token);
+    }
+
+    std::future<Matrix<M, M, T, Policies>> choleskyDecompositionAsync(CancellationToken token = {}) const requires SquareMatrix<M, N, T> && Arithmetic<T> {
+        return runAsync([self = *this] { return self.choleskyDecomposition(); }, token);
+    }
+
+    std::future<Matrix<M, 1, T, Policies>> solveAsync(const Matrix<M, 1, T, Policies>& b, CancellationToken token = {}) const requires Arithmetic<T> {
+        return runAsync([self = *this, b] { return self.solve(b); }, token);
+    }
+
+    std::future<Matrix<M, 1, T, Policies>> solveWithDecomposeAsync(const Matrix<M, 1, T, Policies>& b, CancellationToken token = {}) const requires Arithmetic<T> {
+        return runAsync([self = *this, b] { return self.solveWithDecompose(b); }, token);
+    }
+
     //=================================OPERATORS====================================================================================
 
-    Matrix<M, N, T> operator*(T scalar) const {
-        Matrix<M, N, T> result;
+    constexpr Matrix operator*(T scalar) const & {
+        Matrix result;
         for (int i = 0; i < M; ++i) {
             for (int j = 0; j < N; ++j) {
                 result.data[i][j] = this->data[i][j] * scalar;
@@ -222,16 +723,29 @@ public:
         return result;
     }
 
-    T& operator()(int row, int col) {
+    // A temporary left operand is scaled in place and handed on
+    constexpr Matrix operator*(T scalar) && {
+        return std::move(*this *= scalar);
+    }
+
+    friend constexpr Matrix operator*(T scalar, const Matrix& matrix) {
+        return matrix * scalar;
+    }
+
+    friend constexpr Matrix operator*(T scalar, Matrix&& matrix) {
+        return std::move(matrix) * scalar;
+    }
+
+    constexpr T& operator()(int row, int col) {
         return data[row][col];
     }
 
-    const T& operator()(int row, int col) const {
+    constexpr const T& operator()(int row, int col) const {
         return data[row][col];
     }
 
-    Matrix<M, N, T> operator-() const requires Negatable<T> {
-        Matrix<M, N, T> result;
+    constexpr Matrix operator-() const & requires Negatable<T> {
+        Matrix result;
         for (int i = 0; i < M; ++i) {
             for (int j = 0; j < N; ++j) {
                 result.data[i][j] = -this->data[i][j];
@@ -240,8 +754,18 @@ public:
         return result;
     }
 
-    Matrix<M, N, T> operator+(const Matrix<M, N, T>& rhs) const requires Addable<T> {
-        Matrix<M, N, T> result;
+    constexpr Matrix operator-() && requires Negatable<T> {
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                data[i][j] = -data[i][j];
+            }
+        }
+        return std::move(*this);
+    }
+
+    constexpr Matrix operator+(const Matrix& rhs) const & requires Addable<T> {
+        Scope scope("Matrix::operator+", M * N, M, N);
+        Matrix result;
         for (int i = 0; i < M; ++i) {
             for (int j = 0; j < N; ++j) {
                 result.data[i][j] = this->data[i][j] + rhs.data[i][j];
@@ -250,12 +774,169 @@ public:
         return result;
     }
 
+    // Sums involving a temporary reuse its storage instead of allocating a result
+    constexpr Matrix operator+(const Matrix& rhs) && requires Addable<T> {
+        return std::move(*this += rhs);
+    }
+
+    constexpr Matrix operator+(Matrix&& rhs) const & requires Addable<T> {
+        Scope scope("Matrix::operator+", M * N, M, N);
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                rhs.data[i][j] = this->data[i][j] + rhs.data[i][j];
+            }
+        }
+        return std::move(rhs);
+    }
+
+    constexpr Matrix operator+(Matrix&& rhs) && requires Addable<T> {
+        return std::move(*this += rhs);
+    }
+
+    constexpr Matrix operator-(const Matrix& rhs) const & requires Arithmetic<T> {
+        Scope scope("Matrix::operator-", M * N, M, N);
+        Matrix result;
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                result.data[i][j] = this->data[i][j] - rhs.data[i][j];
+            }
+        }
+        return result;
+    }
+
+    constexpr Matrix operator-(const Matrix& rhs) && requires Arithmetic<T> {
+        return std::move(*this -= rhs);
+    }
+
+    constexpr Matrix operator-(Matrix&& rhs) const & requires Arithmetic<T> {
+        Scope scope("Matrix::operator-", M * N, M, N);
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                rhs.data[i][j] = this->data[i][j] - rhs.data[i][j];
+            }
+        }
+        return std::move(rhs);
+    }
+
+    constexpr Matrix operator-(Matrix&& rhs) && requires Arithmetic<T> {
+        return std::move(*this -= rhs);
+    }
+
+    // Sums and differences with an M x N view or block read it in place instead of converting it to a Matrix
+    template<RowIndexable<T> View>
+    Matrix operator+(const View& rhs) const & requires Addable<T> {
+        Scope scope("Matrix::operator+", M * N, M, N);
+        checkViewShape(rhs, M, N);
+        Matrix result;
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                result.data[i][j] = this->data[i][j] + rhs[i][j];
+            }
+        }
+        return result;
+    }
+
+    template<RowIndexable<T> View>
+    Matrix operator+(const View& rhs) && requires Addable<T> {
+        return std::move(*this += rhs);
+    }
+
+    template<RowIndexable<T> View>
+    Matrix operator-(const View& rhs) const & requires Arithmetic<T> {
+        Scope scope("Matrix::operator-", M * N, M, N);
+        checkViewShape(rhs, M, N);
+        Matrix result;
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                result.data[i][j] = this->data[i][j] - rhs[i][j];
+            }
+        }
+        return result;
+    }
+
+    template<RowIndexable<T> View>
+    Matrix operator-(const View& rhs) && requires Arithmetic<T> {
+        return std::move(*this -= rhs);
+    }
+
+    constexpr Matrix& operator+=(const Matrix& rhs) requires Addable<T> {
+        Scope scope("Matrix::operator+=", M * N, M, N);
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                data[i][j] = data[i][j] + rhs.data[i][j];
+            }
+        }
+        return *this;
+    }
+
+    constexpr Matrix& operator-=(const Matrix& rhs) requires Arithmetic<T> {
+        Scope scope("Matrix::operator-=", M * N, M, N);
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                data[i][j] = data[i][j] - rhs.data[i][j];
+            }
+        }
+        return *this;
+    }
+
+    template<RowIndexable<T> View>
+    Matrix& operator+=(const View& rhs) requires Addable<T> {
+        Scope scope("Matrix::operator+=", M * N, M, N);
+        checkViewShape(rhs, M, N);
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                data[i][j] = data[i][j] + rhs[i][j];
+            }
+        }
+        return *this;
+    }
+
+    template<RowIndexable<T> View>
+    Matrix& operator-=(const View& rhs) requires Arithmetic<T> {
+        Scope scope("Matrix::operator-=", M * N, M, N);
+        checkViewShape(rhs, M, N);
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                data[i][j] = data[i][j] - rhs[i][j];
+            }
+        }
+        return *this;
+    }
+
+    constexpr Matrix& operator*=(T scalar) requires Multiplicable<T> {
+        Scope scope("Matrix::operator*=", M * N, M, N);
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                data[i][j] = data[i][j] * scalar;
+            }
+        }
+        return *this;
+    }
+
+    // Right-multiplies by a square matrix; the product needs fresh storage, which then replaces ours
+    constexpr Matrix& operator*=(const Matrix<N, N, T, Policies>& other) requires Arithmetic<T> {
+        *this = multiply(other);
+        return *this;
+    }
+
+    // Right-multiplies by an N x N view or block
+    template<RowIndexable<T> View>
+    Matrix& operator*=(const View& other) requires Arithmetic<T> {
+        *this = multiply<N>(other);
+        return *this;
+    }
+
     template<int P>
-    Matrix<M, P, T, Policies> operator*(const Matrix<N, P, T, Policies>& other) const requires Arithmetic<T> {
+    constexpr Matrix<M, P, T, Policies> operator*(const Matrix<N, P, T, Policies>& other) const requires Arithmetic<T> {
         return this->multiply(other);
     }
 
-    friend std::ostream& operator<<(std::ostream& os, const Matrix<M, N, T>& matrix) requires Streamable<T> {
+    template<int P>
+    constexpr Matrix<M, P, T, Policies> operator*(const TransposedMatrix<P, N, T, Policies>& other) const requires Arithmetic<T> {
+        return this->multiply(other);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Matrix& matrix) requires Streamable<T> {
         std::cout << std::endl;
         for (int i = 0; i < M; ++i) {
             for (int j = 0; j < N; ++j) {
@@ -268,7 +949,117 @@ public:
     }
 
 private:
-    T data[M][N];
+    template<int, int, typename, typename>
+    friend class Matrix;
+
+    using Scope = typename PolicyInstrumentation<Policies>::type::Scope;
+
+    // Nominal FLOP counts reported to the instrumentation
+    static constexpr double luFlops = 2.0 * M * M * M / 3;
+    static constexpr double qrFlops = 2.0 * M * N * N - 2.0 * N * N * N / 3;
+    static constexpr double solveFlops = luFlops + 2.0 * M * M;
+    static constexpr double updateFlops = 4.0 * M * M;
+    // Several Jacobi sweeps of 3 * M * N * N / 2 flops each, with rotations accumulated
+    static constexpr double svdFlops = 8.0 * 3 * M * N * N;
+
+    template<typename Policy, typename F>
+    static auto invokePolicy(double flops, F&& call) {
+        Scope scope(policyName<Policy>(), flops, M, N);
+        WorkspaceScope workspace(policyWorkspaceResource<Policies>());
+        ExecutorScope executor(policyExecutor<Policies>());
+        return call();
+    }
+
+    // One rank-one modification per column of V, on a copy so that a failed downdate leaves L as it was
+    template<int K>
+    void modifyCholesky(const Matrix<M, K, T, Policies>& V, bool downdate) {
+        Scope scope(downdate ? "Matrix::choleskyDowndate" : "Matrix::choleskyUpdate", K * updateFlops, M, N);
+        auto L = toVectorMatrix();
+        auto columns = V.transpose().toVectorMatrix();
+        invokePolicy<typename Policies::CholeskyUpdatePolicy>(K * updateFlops, [&] {
+            for (const std::vector<T>& x : columns) {
+                if (downdate) {
+                    Policies::CholeskyUpdatePolicy::downdate(L, x);
+                } else {
+                    Policies::CholeskyUpdatePolicy::update(L, x);
+                }
+            }
+        });
+        *this = Matrix(L);
+    }
+
+    // For kernels called outside invokePolicy
+    template<typename F>
+    static void onPolicyExecutor(F&& call) {
+        ExecutorScope executor(policyExecutor<Policies>());
+        call();
+    }
+
+    template<typename F>
+    static auto runAsync(F&& call, CancellationToken token) {
+        MatrixExecutor* executor = policyExecutor<Policies>();
+        return (executor != nullptr ? *executor : MatrixExecutor::shared()).submit(std::forward<F>(call), std::move(token));
+    }
+
+    // Small matrices bypass the runtime-sized policies and use the unrolled, stack-only kernels
+    template<int Rows, int Cols>
+    static constexpr bool fitsFixedSizeKernels = Rows <= fixedSizeKernelLimit<Policies>() && Cols <= fixedSizeKernelLimit<Policies>();
+
+    // Views carry their extents at runtime, so operations taking one check them on entry
+    template<typename View>
+    static void checkViewShape(const View& view, std::size_t rows, std::size_t cols) {
+        if (view.size() != rows || (rows > 0 && view[0].size() != cols)) {
+            throw std::invalid_argument("Invalid dimensions of the view operand.");
+        }
+    }
+
+    MatrixStorage<M, N, T, (M * N * sizeof(T) > heapStorageBytes<Policies>())> data;
+};
+
+// The transpose of a Matrix<M, N> as an N x M operand that is never materialized unless
+// needed. Products with it dispatch to the policy set's TransposedMultiplicationPolicy,
+// which reads the original storage. It holds a reference to the source matrix.
+template <int M, int N, typename T, typename Policies>
+class TransposedMatrix {
+public:
+    explicit constexpr TransposedMatrix(const Matrix<M, N, T, Policies>& matrix) : matrix(matrix) {}
+
+    constexpr const T& operator()(int row, int col) const {
+        return matrix(col, row);
+    }
+
+    constexpr const Matrix<M, N, T, Policies>& source() const {
+        return matrix;
+    }
+
+    ConstMatrixView<T> view() const {
+        return matrix.view().transpose();
+    }
+
+    constexpr Matrix<N, M, T, Policies> materialize() const {
+        return matrix.transpose();
+    }
+
+    constexpr operator Matrix<N, M, T, Policies>() const {
+        return materialize();
+    }
+
+    template<int P>
+    constexpr Matrix<N, P, T, Policies> operator*(const Matrix<M, P, T, Policies>& other) const requires Arithmetic<T> {
+        return matrix.transposeMultiply(other);
+    }
+
+    template<int P>
+    constexpr Matrix<N, P, T, Policies> operator*(const TransposedMatrix<P, M, T, Policies>& other) const requires Arithmetic<T> {
+        return matrix.transposeMultiply(other);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const TransposedMatrix& transposed) requires Streamable<T> {
+        return os << transposed.materialize();
+    }
+
+private:
+    const Matrix<M, N, T, Policies>& matrix;
 };
 
 #endif // MATRIX_HPP
\ No newline at end of file
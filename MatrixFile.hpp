@@ -0,0 +1,293 @@
+#ifndef MATRIX_FILE_HPP
+#define MATRIX_FILE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Concepts.hpp"
+#include "MatrixView.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MATRIX_HAS_MMAP 1
+#else
+#define MATRIX_HAS_MMAP 0
+#endif
+
+// Binary matrix files: a fixed 64-byte little-endian header followed, at payloadOffset,
+// by the raw elements in the stored layout. The payload offset is a multiple of the
+// alignment recorded in the header, so a mapped payload can be used in place.
+//
+//   offset  size  field
+//        0     8  magic "MATRIXB\0"
+//        8     4  version (1)
+//       12     4  byte-order mark 0x01020304 as written by the producer
+//       16     4  data type (MatrixFileDataType)
+//       20     4  layout (MatrixFileLayout)
+//       24     8  rows
+//       32     8  cols
+//       40     8  payload offset
+//       48     4  payload alignment
+//       52     4  tile size (Tiled layout only, otherwise zero)
+//       56     8  reserved, zero
+
+enum class MatrixFileDataType : std::uint32_t {
+    Float32 = 1,
+    Float64 = 2,
+    Int32 = 3,
+    Int64 = 4
+};
+
+enum class MatrixFileLayout : std::uint32_t {
+    RowMajor = 0,
+    ColumnMajor = 1,
+    // Square tiles, each stored row-major and padded to full size, tiles in row-major order (see OutOfCore.hpp)
+    Tiled = 2
+};
+
+struct MatrixFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t dataType;
+    std::uint32_t layout;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint64_t payloadOffset;
+    std::uint32_t alignment;
+    std::uint32_t tileSize;
+    std::uint8_t reserved[8];
+};
+
+static_assert(sizeof(MatrixFileHeader) == 64, "MatrixFileHeader must stay 64 bytes");
+
+constexpr char MatrixFileMagic[8] = {'M', 'A', 'T', 'R', 'I', 'X', 'B', '\0'};
+constexpr std::uint32_t MatrixFileVersion = 1;
+constexpr std::uint32_t MatrixFileByteOrder = 0x01020304;
+
+template<typename T>
+constexpr MatrixFileDataType matrixFileDataType() {
+    if constexpr (std::is_same_v<T, float>) {
+        return MatrixFileDataType::Float32;
+    } else if constexpr (std::is_same_v<T, double>) {
+        return MatrixFileDataType::Float64;
+    } else if constexpr (std::is_same_v<T, std::int32_t>) {
+        return MatrixFileDataType::Int32;
+    } else if constexpr (std::is_same_v<T, std::int64_t>) {
+        return MatrixFileDataType::Int64;
+    } else {
+        static_assert(sizeof(T) == 0, "Unsupported element type for matrix files.");
+    }
+}
+
+// Writes `matrix` (anything indexable as matrix[i][j]) to `path`
+template<typename T, RowIndexable<T> Rows>
+void writeMatrixFile(const std::string& path, const Rows& matrix, MatrixFileLayout layout = MatrixFileLayout::RowMajor, std::uint32_t alignment = 64) {
+    if (layout == MatrixFileLayout::Tiled) {
+        throw std::invalid_argument("Use TiledMatrix to write tiled matrix files.");
+    }
+    if (alignment < sizeof(MatrixFileHeader) || (alignment & (alignment - 1)) != 0) {
+        throw std::invalid_argument("Matrix file alignment must be a power of two of at least 64 bytes.");
+    }
+    std::uint64_t rows = matrix.size();
+    std::uint64_t cols = rows > 0 ? matrix[0].size() : 0;
+
+    MatrixFileHeader header{};
+    std::memcpy(header.magic, MatrixFileMagic, sizeof(header.magic));
+    header.version = MatrixFileVersion;
+    header.byteOrder = MatrixFileByteOrder;
+    header.dataType = static_cast<std::uint32_t>(matrixFileDataType<T>());
+    header.layout = static_cast<std::uint32_t>(layout);
+    header.rows = rows;
+    header.cols = cols;
+    header.payloadOffset = alignment;
+    header.alignment = alignment;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Cannot open matrix file for writing: " + path);
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<char> padding(header.payloadOffset - sizeof(header), 0);
+    file.write(padding.data(), padding.size());
+
+    std::vector<T> line(layout == MatrixFileLayout::RowMajor ? cols : rows);
+    std::uint64_t outer = layout == MatrixFileLayout::RowMajor ? rows : cols;
+    for (std::uint64_t o = 0; o < outer; ++o) {
+        for (std::uint64_t k = 0; k < line.size(); ++k) {
+            line[k] = layout == MatrixFileLayout::RowMajor ? static_cast<T>(matrix[o][k]) : static_cast<T>(matrix[k][o]);
+        }
+        file.write(reinterpret_cast<const char*>(line.data()), line.size() * sizeof(T));
+    }
+    if (!file) {
+        throw std::runtime_error("Failed to write matrix file: " + path);
+    }
+}
+
+// A matrix file mapped read-only into memory. Opening validates the header; elements are
+// only paged in when the view touches them. Where mmap is unavailable the payload is read
+// into an owned buffer instead.
+template<typename T>
+class MappedMatrixFile {
+public:
+    explicit MappedMatrixFile(const std::string& path) {
+#if MATRIX_HAS_MMAP
+        descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            throw std::runtime_error("Cannot open matrix file: " + path);
+        }
+        struct stat status;
+        if (::fstat(descriptor, &status) != 0) {
+            close();
+            throw std::runtime_error("Cannot stat matrix file: " + path);
+        }
+        length = static_cast<std::size_t>(status.st_size);
+        if (length < sizeof(MatrixFileHeader)) {
+            close();
+            throw std::runtime_error("Matrix file is too small to hold a header: " + path);
+        }
+        void* address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, descriptor, 0);
+        if (address == MAP_FAILED) {
+            close();
+            throw std::runtime_error("Cannot map matrix file: " + path);
+        }
+        mapping = static_cast<const char*>(address);
+#else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            throw std::runtime_error("Cannot open matrix file: " + path);
+        }
+        buffer.resize(static_cast<std::size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(buffer.data(), buffer.size());
+        length = buffer.size();
+        mapping = buffer.data();
+        if (length < sizeof(MatrixFileHeader)) {
+            throw std::runtime_error("Matrix file is too small to hold a header: " + path);
+        }
+#endif
+        try {
+            validate(path);
+        } catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    ~MappedMatrixFile() {
+        close();
+    }
+
+    MappedMatrixFile(const MappedMatrixFile&) = delete;
+    MappedMatrixFile& operator=(const MappedMatrixFile&) = delete;
+
+    MappedMatrixFile(MappedMatrixFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedMatrixFile& operator=(MappedMatrixFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            std::memcpy(&header, &other.header, sizeof(header));
+            mapping = other.mapping;
+            length = other.length;
+            descriptor = other.descriptor;
+#if !MATRIX_HAS_MMAP
+            buffer = std::move(other.buffer);
+#endif
+            other.mapping = nullptr;
+            other.length = 0;
+            other.descriptor = -1;
+        }
+        return *this;
+    }
+
+    ConstMatrixView<T> view() const {
+        const T* payload = reinterpret_cast<const T*>(mapping + header.payloadOffset);
+        if (layout() == MatrixFileLayout::RowMajor) {
+            return ConstMatrixView<T>::rowMajor(payload, header.rows, header.cols);
+        }
+        return ConstMatrixView<T>::columnMajor(payload, header.rows, header.cols);
+    }
+
+    std::size_t rows() const {
+        return header.rows;
+    }
+
+    std::size_t cols() const {
+        return header.cols;
+    }
+
+    MatrixFileLayout layout() const {
+        return static_cast<MatrixFileLayout>(header.layout);
+    }
+
+    // Asks the kernel to read the whole payload ahead, for callers about to stream through it
+    void prefetch() const {
+#if MATRIX_HAS_MMAP && defined(MADV_WILLNEED)
+        if (mapping != nullptr) {
+            ::madvise(const_cast<char*>(mapping), length, MADV_WILLNEED);
+        }
+#endif
+    }
+
+private:
+    void validate(const std::string& path) {
+        std::memcpy(&header, mapping, sizeof(header));
+        if (std::memcmp(header.magic, MatrixFileMagic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("Not a matrix file: " + path);
+        }
+        if (header.byteOrder != MatrixFileByteOrder) {
+            throw std::runtime_error("Matrix file was written with a different byte order: " + path);
+        }
+        if (header.version != MatrixFileVersion) {
+            throw std::runtime_error("Unsupported matrix file version " + std::to_string(header.version) + ": " + path);
+        }
+        if (header.dataType != static_cast<std::uint32_t>(matrixFileDataType<T>())) {
+            throw std::runtime_error("Matrix file element type does not match the requested type: " + path);
+        }
+        if (header.layout == static_cast<std::uint32_t>(MatrixFileLayout::Tiled)) {
+            throw std::runtime_error("Tiled matrix files have no dense view; open them as a TiledMatrix: " + path);
+        }
+        if (header.layout > static_cast<std::uint32_t>(MatrixFileLayout::ColumnMajor)) {
+            throw std::runtime_error("Unknown matrix file layout: " + path);
+        }
+        if (header.payloadOffset < sizeof(header) || header.payloadOffset > length || header.payloadOffset % alignof(T) != 0 ||
+            (header.cols != 0 && header.rows > (length - header.payloadOffset) / sizeof(T) / header.cols) ||
+            header.payloadOffset + header.rows * header.cols * sizeof(T) > length) {
+            throw std::runtime_error("Matrix file payload is truncated or misaligned: " + path);
+        }
+    }
+
+    void close() {
+#if MATRIX_HAS_MMAP
+        if (mapping != nullptr) {
+            ::munmap(const_cast<char*>(mapping), length);
+        }
+        if (descriptor >= 0) {
+            ::close(descriptor);
+        }
+#endif
+        mapping = nullptr;
+        descriptor = -1;
+    }
+
+    MatrixFileHeader header{};
+    const char* mapping = nullptr;
+    std::size_t length = 0;
+    int descriptor = -1;
+#if !MATRIX_HAS_MMAP
+    std::vector<char> buffer;
+#endif
+};
+
+#endif // MATRIX_FILE_HPP
@@ -0,0 +1,88 @@
+#ifndef MATRIX_STORAGE_HPP
+#define MATRIX_STORAGE_HPP
+
+#include <algorithm>
+#include <memory>
+
+// Element storage for Matrix<M, N, T>. Small matrices keep their elements inline, so they
+// stay usable in constant expressions and cost nothing to create. Matrices above the policy
+// set's HeapStorageBytes keep them in one heap block instead, which makes moving them O(1)
+// and keeps large temporaries off the stack. A moved-from heap matrix holds no elements and
+// may only be assigned to or destroyed.
+
+template<int M, int N, typename T, bool OnHeap>
+class MatrixStorage;
+
+template<int M, int N, typename T>
+class MatrixStorage<M, N, T, false> {
+public:
+    using Array = T[M][N];
+
+    constexpr Array& array() {
+        return elements;
+    }
+
+    constexpr const Array& array() const {
+        return elements;
+    }
+
+    constexpr T (&operator[](int i))[N] {
+        return elements[i];
+    }
+
+    constexpr const T (&operator[](int i) const)[N] {
+        return elements[i];
+    }
+
+private:
+    T elements[M][N];
+};
+
+template<int M, int N, typename T>
+class MatrixStorage<M, N, T, true> {
+public:
+    using Array = T[M][N];
+
+    MatrixStorage() : block(std::make_unique<Block>()) {}
+
+    MatrixStorage(const MatrixStorage& other) : block(std::make_unique<Block>(*other.block)) {}
+
+    MatrixStorage(MatrixStorage&& other) noexcept = default;
+
+    MatrixStorage& operator=(const MatrixStorage& other) {
+        if (this != &other) {
+            if (!block) {
+                block = std::make_unique<Block>();
+            }
+            std::copy_n(&other.block->elements[0][0], M * N, &block->elements[0][0]);
+        }
+        return *this;
+    }
+
+    MatrixStorage& operator=(MatrixStorage&& other) noexcept = default;
+
+    Array& array() {
+        return block->elements;
+    }
+
+    const Array& array() const {
+        return block->elements;
+    }
+
+    T (&operator[](int i))[N] {
+        return block->elements[i];
+    }
+
+    const T (&operator[](int i) const)[N] {
+        return block->elements[i];
+    }
+
+private:
+    struct Block {
+        T elements[M][N];
+    };
+
+    std::unique_ptr<Block> block;
+};
+
+#endif // MATRIX_STORAGE_HPP
@@ -0,0 +1,321 @@
+#ifndef MATRIX_VIEW_HPP
+#define MATRIX_VIEW_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Non-owning access to a dense block of elements: a base pointer (the offset), extents and
+// row/column strides (the row stride is the leading dimension). Indexing mirrors
+// std::vector<std::vector<T>> (view[i][j], view.size(), view[i].size()), so policies written
+// against RowIndexable accept views. Slicing a view with block(), row() or col() is O(1).
+
+template<typename T>
+class RowView {
+public:
+    RowView(T* first, std::size_t length, std::ptrdiff_t stride) : first(first), length(length), stride(stride) {}
+
+    T& operator[](std::size_t j) const {
+        return first[static_cast<std::ptrdiff_t>(j) * stride];
+    }
+
+    std::size_t size() const {
+        return length;
+    }
+
+private:
+    T* first;
+    std::size_t length;
+    std::ptrdiff_t stride;
+};
+
+template<typename T>
+using ConstRowView = RowView<const T>;
+
+template<typename T>
+class MatrixView;
+
+template<typename T>
+class ConstMatrixView {
+public:
+    ConstMatrixView() = default;
+
+    ConstMatrixView(const T* data, std::size_t rows, std::size_t cols, std::ptrdiff_t rowStride, std::ptrdiff_t colStride = 1)
+        : base(data), rowCount(rows), colCount(cols), rowStride(rowStride), colStride(colStride) {}
+
+    static ConstMatrixView rowMajor(const T* data, std::size_t rows, std::size_t cols) {
+        return ConstMatrixView(data, rows, cols, static_cast<std::ptrdiff_t>(cols), 1);
+    }
+
+    static ConstMatrixView columnMajor(const T* data, std::size_t rows, std::size_t cols) {
+        return ConstMatrixView(data, rows, cols, 1, static_cast<std::ptrdiff_t>(rows));
+    }
+
+    ConstRowView<T> operator[](std::size_t i) const {
+        return ConstRowView<T>(base + static_cast<std::ptrdiff_t>(i) * rowStride, colCount, colStride);
+    }
+
+    const T& operator()(std::size_t i, std::size_t j) const {
+        return base[static_cast<std::ptrdiff_t>(i) * rowStride + static_cast<std::ptrdiff_t>(j) * colStride];
+    }
+
+    // The r x c block whose top-left element is (i, j)
+    ConstMatrixView block(std::size_t i, std::size_t j, std::size_t r, std::size_t c) const {
+        if (i + r > rowCount || j + c > colCount) {
+            throw std::out_of_range("Block exceeds the bounds of the view.");
+        }
+        return ConstMatrixView(&(*this)(i, j), r, c, rowStride, colStride);
+    }
+
+    ConstMatrixView row(std::size_t i) const {
+        return block(i, 0, 1, colCount);
+    }
+
+    ConstMatrixView col(std::size_t j) const {
+        return block(0, j, rowCount, 1);
+    }
+
+    ConstMatrixView transpose() const {
+        return ConstMatrixView(base, colCount, rowCount, colStride, rowStride);
+    }
+
+    std::size_t size() const {
+        return rowCount;
+    }
+
+    std::size_t rows() const {
+        return rowCount;
+    }
+
+    std::size_t cols() const {
+        return colCount;
+    }
+
+    std::ptrdiff_t leadingDimension() const {
+        return rowStride;
+    }
+
+    const T* data() const {
+        return base;
+    }
+
+    bool isRowMajor() const {
+        return colStride == 1 && rowStride == static_cast<std::ptrdiff_t>(colCount);
+    }
+
+    // Copies the viewed elements out, for policies that still need an owning matrix
+    std::vector<std::vector<T>> toVectorMatrix() const {
+        std::vector<std::vector<T>> result(rowCount, std::vector<T>(colCount));
+        for (std::size_t i = 0; i < rowCount; ++i) {
+            for (std::size_t j = 0; j < colCount; ++j) {
+                result[i][j] = (*this)(i, j);
+            }
+        }
+        return result;
+    }
+
+private:
+    const T* base = nullptr;
+    std::size_t rowCount = 0;
+    std::size_t colCount = 0;
+    std::ptrdiff_t rowStride = 0;
+    std::ptrdiff_t colStride = 1;
+};
+
+template<typename T>
+class MatrixView {
+public:
+    MatrixView() = default;
+
+    MatrixView(T* data, std::size_t rows, std::size_t cols, std::ptrdiff_t rowStride, std::ptrdiff_t colStride = 1)
+        : base(data), rowCount(rows), colCount(cols), rowStride(rowStride), colStride(colStride) {}
+
+    operator ConstMatrixView<T>() const {
+        return ConstMatrixView<T>(base, rowCount, colCount, rowStride, colStride);
+    }
+
+    RowView<T> operator[](std::size_t i) const {
+        return RowView<T>(base + static_cast<std::ptrdiff_t>(i) * rowStride, colCount, colStride);
+    }
+
+    T& operator()(std::size_t i, std::size_t j) const {
+        return base[static_cast<std::ptrdiff_t>(i) * rowStride + static_cast<std::ptrdiff_t>(j) * colStride];
+    }
+
+    MatrixView block(std::size_t i, std::size_t j, std::size_t r, std::size_t c) const {
+        if (i + r > rowCount || j + c > colCount) {
+            throw std::out_of_range("Block exceeds the bounds of the view.");
+        }
+        return MatrixView(&(*this)(i, j), r, c, rowStride, colStride);
+    }
+
+    MatrixView row(std::size_t i) const {
+        return block(i, 0, 1, colCount);
+    }
+
+    MatrixView col(std::size_t j) const {
+        return block(0, j, rowCount, 1);
+    }
+
+    MatrixView transpose() const {
+        return MatrixView(base, colCount, rowCount, colStride, rowStride);
+    }
+
+    // Copies `source` (anything indexable as source[i][j] with the same extents) into the viewed elements
+    template<typename Rows>
+    const MatrixView& assign(const Rows& source) const {
+        if (source.size() != rowCount || (rowCount > 0 && source[0].size() != colCount)) {
+            throw std::invalid_argument("Invalid dimensions for view assignment.");
+        }
+        for (std::size_t i = 0; i < rowCount; ++i) {
+            for (std::size_t j = 0; j < colCount; ++j) {
+                (*this)(i, j) = source[i][j];
+            }
+        }
+        return *this;
+    }
+
+    const MatrixView& fill(const T& value) const {
+        for (std::size_t i = 0; i < rowCount; ++i) {
+            for (std::size_t j = 0; j < colCount; ++j) {
+                (*this)(i, j) = value;
+            }
+        }
+        return *this;
+    }
+
+    std::size_t size() const {
+        return rowCount;
+    }
+
+    std::size_t rows() const {
+        return rowCount;
+    }
+
+    std::size_t cols() const {
+        return colCount;
+    }
+
+    std::ptrdiff_t leadingDimension() const {
+        return rowStride;
+    }
+
+    T* data() const {
+        return base;
+    }
+
+    std::vector<std::vector<T>> toVectorMatrix() const {
+        return ConstMatrixView<T>(*this).toVectorMatrix();
+    }
+
+private:
+    T* base = nullptr;
+    std::size_t rowCount = 0;
+    std::size_t colCount = 0;
+    std::ptrdiff_t rowStride = 0;
+    std::ptrdiff_t colStride = 1;
+};
+
+// O(1) window into any row-indexable matrix, including std::vector<std::vector<T>> whose
+// rows are separate allocations and therefore have no common stride. Blocks of a block
+// have the same type, so recursive algorithms instantiate a fixed set of types.
+template<typename Rows>
+class BlockView {
+public:
+    class Row {
+    public:
+        Row(const Rows& source, std::size_t row, std::size_t colOffset, std::size_t length)
+            : source(&source), row(row), colOffset(colOffset), length(length) {}
+
+        decltype(auto) operator[](std::size_t j) const {
+            return (*source)[row][colOffset + j];
+        }
+
+        std::size_t size() const {
+            return length;
+        }
+
+    private:
+        const Rows* source;
+        std::size_t row;
+        std::size_t colOffset;
+        std::size_t length;
+    };
+
+    explicit BlockView(const Rows& source)
+        : source(&source), rowOffset(0), colOffset(0), rowCount(source.size()), colCount(source.size() > 0 ? source[0].size() : 0) {}
+
+    BlockView(const Rows& source, std::size_t i, std::size_t j, std::size_t r, std::size_t c)
+        : source(&source), rowOffset(i), colOffset(j), rowCount(r), colCount(c) {}
+
+    Row operator[](std::size_t i) const {
+        return Row(*source, rowOffset + i, colOffset, colCount);
+    }
+
+    BlockView block(std::size_t i, std::size_t j, std::size_t r, std::size_t c) const {
+        return BlockView(*source, rowOffset + i, colOffset + j, r, c);
+    }
+
+    std::size_t size() const {
+        return rowCount;
+    }
+
+    std::size_t rows() const {
+        return rowCount;
+    }
+
+    std::size_t cols() const {
+        return colCount;
+    }
+
+private:
+    const Rows* source;
+    std::size_t rowOffset;
+    std::size_t colOffset;
+    std::size_t rowCount;
+    std::size_t colCount;
+};
+
+// The r x c block of `matrix` at (i, j) in O(1): views slice themselves, anything else is
+// wrapped in a BlockView (blocks of a BlockView stay BlockViews)
+template<typename Rows>
+BlockView<Rows> subBlock(const Rows& matrix, std::size_t i, std::size_t j, std::size_t r, std::size_t c) {
+    return BlockView<Rows>(matrix, i, j, r, c);
+}
+
+template<typename Rows>
+BlockView<Rows> subBlock(const BlockView<Rows>& matrix, std::size_t i, std::size_t j, std::size_t r, std::size_t c) {
+    return matrix.block(i, j, r, c);
+}
+
+template<typename T>
+ConstMatrixView<T> subBlock(const ConstMatrixView<T>& matrix, std::size_t i, std::size_t j, std::size_t r, std::size_t c) {
+    return matrix.block(i, j, r, c);
+}
+
+template<typename T>
+ConstMatrixView<T> subBlock(const MatrixView<T>& matrix, std::size_t i, std::size_t j, std::size_t r, std::size_t c) {
+    return ConstMatrixView<T>(matrix).block(i, j, r, c);
+}
+
+// `matrix` itself when it already is a std::vector<std::vector<T>>, otherwise an owning copy;
+// bind the result to a const reference.
+template<typename T, typename Rows>
+decltype(auto) denseRows(const Rows& matrix) {
+    if constexpr (std::is_same_v<Rows, std::vector<std::vector<T>>>) {
+        return (matrix);
+    } else {
+        std::size_t rows = matrix.size();
+        std::size_t cols = rows > 0 ? matrix[0].size() : 0;
+        std::vector<std::vector<T>> copy(rows, std::vector<T>(cols));
+        for (std::size_t i = 0; i < rows; ++i) {
+            for (std::size_t j = 0; j < cols; ++j) {
+                copy[i][j] = matrix[i][j];
+            }
+        }
+        return copy;
+    }
+}
+
+#endif // MATRIX_VIEW_HPP
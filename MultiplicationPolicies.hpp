@@ -3,14 +3,20 @@
 
 #include <vector>
 #include <cmath>
+#include <algorithm>
+
+#include "Concepts.hpp"
+#include "Executor.hpp"
+#include "MatrixView.hpp"
+#include "Workspace.hpp"
 
 template<typename T>
 class StandardMatrixMultiplication {
 public:
-    static std::vector<std::vector<T>> calculate(const std::vector<std::vector<T>>& matrixA, const std::vector<std::vector<T>>& matrixB) {
+    template<RowIndexable<T> MatrixA, RowIndexable<T> MatrixB>
+    static std::vector<std::vector<T>> calculate(const MatrixA& matrixA, const MatrixB& matrixB) {
         int rowsA = matrixA.size();
         int colsA = matrixA[0].size();
-        int rowsB = matrixB.size();
         int colsB = matrixB[0].size();
 
         std::vector<std::vector<T>> result(rowsA, std::vector<T>(colsB, 0));
@@ -25,176 +31,422 @@ public:
     }
 };
 
-template<typename T>
-class DivideAndConquerMultiplication {
+// Loop tiling over i, k and j so that a BlockSize x BlockSize tile of each operand
+// stays in cache while it is reused; the innermost loop streams along rows of B and C.
+template<typename T, int BlockSize = 64>
+class BlockedMatrixMultiplication {
 public:
-    static std::vector<std::vector<T>> calculate(const std::vector<std::vector<T>>& A, const std::vector<std::vector<T>>& B) {
-        int n = A.size();
-        std::vector<std::vector<T>> result(n, std::vector<T>(n, 0));
+    // Below this many multiply-adds the work is not worth handing to other threads
+    static constexpr double ParallelWork = 1 << 24;
 
-        if (n == 1) {
-            result[0][0] = A[0][0] * B[0][0];
+    template<RowIndexable<T> MatrixA, RowIndexable<T> MatrixB>
+    static std::vector<std::vector<T>> calculate(const MatrixA& matrixA, const MatrixB& matrixB) {
+        int rowsA = matrixA.size();
+        int colsA = matrixA[0].size();
+        int colsB = matrixB[0].size();
+
+        std::vector<std::vector<T>> result(rowsA, std::vector<T>(colsB, 0));
+        // Blocks of result rows are independent, so large products hand them to the executor
+        auto rowBlock = [&](int block) {
+            int ii = block * BlockSize;
+            int iEnd = std::min(ii + BlockSize, rowsA);
+            for (int kk = 0; kk < colsA; kk += BlockSize) {
+                int kEnd = std::min(kk + BlockSize, colsA);
+                for (int jj = 0; jj < colsB; jj += BlockSize) {
+                    int jEnd = std::min(jj + BlockSize, colsB);
+                    for (int i = ii; i < iEnd; ++i) {
+                        T* resultRow = result[i].data();
+                        for (int k = kk; k < kEnd; ++k) {
+                            T a = matrixA[i][k];
+                            const auto& rowB = matrixB[k];
+                            for (int j = jj; j < jEnd; ++j) {
+                                resultRow[j] += a * rowB[j];
+                            }
+                        }
+                    }
+                }
+            }
+        };
+        int blocks = (rowsA + BlockSize - 1) / BlockSize;
+        if (static_cast<double>(rowsA) * colsA * colsB >= ParallelWork) {
+            MatrixExecutor::current().parallelFor(blocks, rowBlock);
         } else {
-            int newSize = n / 2;
-            std::vector<std::vector<T>> 
-                a11(newSize, std::vector<T>(newSize)),
-                a12(newSize, std::vector<T>(newSize)),
-                a21(newSize, std::vector<T>(newSize)),
-                a22(newSize, std::vector<T>(newSize)),
-                b11(newSize, std::vector<T>(newSize)),
-                b12(newSize, std::vector<T>(newSize)),
-                b21(newSize, std::vector<T>(newSize)),
-                b22(newSize, std::vector<T>(newSize));
+            for (int block = 0; block < blocks; ++block) {
+                rowBlock(block);
+            }
+        }
+        return result;
+    }
+};
 
-            for (int i = 0; i < newSize; i++) {
-                for (int j = 0; j < newSize; j++) {
-                    a11[i][j] = A[i][j];
-                    a12[i][j] = A[i][j + newSize];
-                    a21[i][j] = A[i + newSize][j];
-                    a22[i][j] = A[i + newSize][j + newSize];
-
-                    b11[i][j] = B[i][j];
-                    b12[i][j] = B[i][j + newSize];
-                    b21[i][j] = B[i + newSize][j];
-                    b22[i][j] = B[i + newSize][j + newSize];
+// Products with transposed operands, reading each operand in the layout it is stored in:
+// nt(A, B) = A * B^T, tn(A, B) = A^T * B and tt(A, B) = A^T * B^T. Every entry is summed over
+// k in ascending order, as StandardMatrixMultiplication does.
+template<typename T, int BlockSize = 64>
+class TransposedMultiplication {
+public:
+    // Below this many multiply-adds tn() is not worth handing to other threads
+    static constexpr double ParallelWork = 1 << 24;
+
+    // Rows of A against rows of B; a block of B's rows is reused for every row of A
+    template<RowIndexable<T> MatrixA, RowIndexable<T> MatrixB>
+    static std::vector<std::vector<T>> nt(const MatrixA& A, const MatrixB& B) {
+        int rowsA = A.size();
+        int inner = A[0].size();
+        int rowsB = B.size();
+
+        std::vector<std::vector<T>> result(rowsA, std::vector<T>(rowsB, 0));
+        for (int jj = 0; jj < rowsB; jj += BlockSize) {
+            int jEnd = std::min(jj + BlockSize, rowsB);
+            for (int i = 0; i < rowsA; ++i) {
+                const auto& rowA = A[i];
+                for (int j = jj; j < jEnd; ++j) {
+                    const auto& rowB = B[j];
+                    T sum = 0;
+                    for (int k = 0; k < inner; ++k) {
+                        sum += rowA[k] * rowB[k];
+                    }
+                    result[i][j] = sum;
                 }
             }
+        }
+        return result;
+    }
 
-            auto c11 = add(calculate(a11, b11), calculate(a12, b21));
-            auto c12 = add(calculate(a11, b12), calculate(a12, b22));
-            auto c21 = add(calculate(a21, b11), calculate(a22, b21));
-            auto c22 = add(calculate(a21, b12), calculate(a22, b22));
+    // Row k of A scales row k of B into the result, so all three are streamed along rows.
+    // Each result tile sums over all of k by itself, so large products hand tiles to the executor.
+    template<RowIndexable<T> MatrixA, RowIndexable<T> MatrixB>
+    static std::vector<std::vector<T>> tn(const MatrixA& A, const MatrixB& B) {
+        int inner = A.size();
+        int colsA = A[0].size();
+        int colsB = B[0].size();
 
-            for (int i = 0; i < newSize; i++) {
-                for (int j = 0; j < newSize; j++) {
-                    result[i][j] = c11[i][j];
-                    result[i][j + newSize] = c12[i][j];
-                    result[i + newSize][j] = c21[i][j];
-                    result[i + newSize][j + newSize] = c22[i][j];
+        std::vector<std::vector<T>> result(colsA, std::vector<T>(colsB, 0));
+        int tilesAcross = (colsB + BlockSize - 1) / BlockSize;
+        auto resultTile = [&](int tile) {
+            int ii = tile / tilesAcross * BlockSize;
+            int iEnd = std::min(ii + BlockSize, colsA);
+            int jj = tile % tilesAcross * BlockSize;
+            int jEnd = std::min(jj + BlockSize, colsB);
+            for (int kk = 0; kk < inner; kk += BlockSize) {
+                int kEnd = std::min(kk + BlockSize, inner);
+                for (int i = ii; i < iEnd; ++i) {
+                    T* resultRow = result[i].data();
+                    for (int k = kk; k < kEnd; ++k) {
+                        T a = A[k][i];
+                        const auto& rowB = B[k];
+                        for (int j = jj; j < jEnd; ++j) {
+                            resultRow[j] += a * rowB[j];
+                        }
+                    }
                 }
             }
+        };
+        int tiles = (colsA + BlockSize - 1) / BlockSize * tilesAcross;
+        if (static_cast<double>(inner) * colsA * colsB >= ParallelWork) {
+            MatrixExecutor::current().parallelFor(tiles, resultTile);
+        } else {
+            for (int tile = 0; tile < tiles; ++tile) {
+                resultTile(tile);
+            }
         }
         return result;
     }
 
-private:
-    static std::vector<std::vector<T>> add(const std::vector<std::vector<T>>& A, const std::vector<std::vector<T>>& B) {
-        int n = A.size();
-        std::vector<std::vector<T>> result(n, std::vector<T>(n));
+    // A^T * B^T = (B * A)^T: multiply in the stored layouts, then transpose tile by tile
+    template<RowIndexable<T> MatrixA, RowIndexable<T> MatrixB>
+    static std::vector<std::vector<T>> tt(const MatrixA& A, const MatrixB& B) {
+        std::vector<std::vector<T>> product = BlockedMatrixMultiplication<T, BlockSize>::calculate(B, A);
+        int rows = product.size();
+        int cols = product[0].size();
 
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                result[i][j] = A[i][j] + B[i][j];
+        constexpr int Tile = 16;
+        std::vector<std::vector<T>> result(cols, std::vector<T>(rows));
+        for (int ii = 0; ii < rows; ii += Tile) {
+            int iEnd = std::min(ii + Tile, rows);
+            for (int jj = 0; jj < cols; jj += Tile) {
+                int jEnd = std::min(jj + Tile, cols);
+                for (int i = ii; i < iEnd; ++i) {
+                    for (int j = jj; j < jEnd; ++j) {
+                        result[j][i] = product[i][j];
+                    }
+                }
             }
         }
         return result;
     }
 };
 
+// Symmetric rank-k products: ata(A) = A^T * A and aat(A) = A * A^T. Only the lower triangle
+// is computed, which halves the work, and it is mirrored into the upper one. Large products
+// split the rows of the result into bands of equal triangle area, one task per band.
+template<typename T, int BlockSize = 64>
+class SymmetricRankK {
+public:
+    // Below this many multiply-adds the work is not worth handing to other threads
+    static constexpr double ParallelWork = 1 << 24;
+
+    template<RowIndexable<T> Rows>
+    static std::vector<std::vector<T>> ata(const Rows& A) {
+        int inner = A.size();
+        int n = A[0].size();
+        std::vector<std::vector<T>> result(n, std::vector<T>(n, 0));
+        inBands(n, inner, [&](int first, int last) {
+            for (int ii = first; ii < last; ii += BlockSize) {
+                int iEnd = std::min(ii + BlockSize, last);
+                for (int kk = 0; kk < inner; kk += BlockSize) {
+                    int kEnd = std::min(kk + BlockSize, inner);
+                    for (int jj = 0; jj < iEnd; jj += BlockSize) {
+                        for (int i = ii; i < iEnd; ++i) {
+                            T* resultRow = result[i].data();
+                            int jEnd = std::min(jj + BlockSize, i + 1);
+                            for (int k = kk; k < kEnd; ++k) {
+                                const auto& rowA = A[k];
+                                T a = rowA[i];
+                                for (int j = jj; j < jEnd; ++j) {
+                                    resultRow[j] += a * rowA[j];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        });
+        mirror(result);
+        return result;
+    }
+
+    template<RowIndexable<T> Rows>
+    static std::vector<std::vector<T>> aat(const Rows& A) {
+        int n = A.size();
+        int inner = A[0].size();
+        std::vector<std::vector<T>> result(n, std::vector<T>(n, 0));
+        inBands(n, inner, [&](int first, int last) {
+            for (int jj = 0; jj < last; jj += BlockSize) {
+                for (int i = std::max(first, jj); i < last; ++i) {
+                    const auto& rowI = A[i];
+                    int jEnd = std::min(jj + BlockSize, i + 1);
+                    for (int j = jj; j < jEnd; ++j) {
+                        const auto& rowJ = A[j];
+                        T sum = 0;
+                        for (int k = 0; k < inner; ++k) {
+                            sum += rowI[k] * rowJ[k];
+                        }
+                        result[i][j] = sum;
+                    }
+                }
+            }
+        });
+        mirror(result);
+        return result;
+    }
+
+private:
+    // Runs work(first, last) over row bands of an n x n lower triangle with inner dimension k
+    template<typename Work>
+    static void inBands(int n, int k, Work&& work) {
+        MatrixExecutor& executor = MatrixExecutor::current();
+        double total = 0.5 * n * n * k;
+        int bands = 1;
+        if (total >= ParallelWork && !executor.inWorker()) {
+            bands = static_cast<int>(std::min<double>(executor.threadCount(), total / (ParallelWork / 4)));
+        }
+        if (bands <= 1) {
+            work(0, n);
+            return;
+        }
+
+        // Row i of the triangle costs about i, so band t ends where t / bands of the area is covered
+        auto bandEnd = [=](int t) {
+            return t == bands ? n : static_cast<int>(n * std::sqrt(static_cast<double>(t) / bands));
+        };
+        executor.parallelFor(bands, [&](int t) {
+            int first = bandEnd(t);
+            int last = bandEnd(t + 1);
+            if (last > first) {
+                work(first, last);
+            }
+        });
+    }
+
+    static void mirror(std::vector<std::vector<T>>& result) {
+        int n = result.size();
+        for (int i = 0; i < n; ++i) {
+            for (int j = i + 1; j < n; ++j) {
+                result[i][j] = result[j][i];
+            }
+        }
+    }
+};
+
 template<typename T>
-class StrassenMultiplication {
+class DivideAndConquerMultiplication {
 public:
-    static std::vector<std::vector<T>> calculate(const std::vector<std::vector<T>>& A, const std::vector<std::vector<T>>& B) {
+    template<RowIndexable<T> MatrixA, RowIndexable<T> MatrixB>
+    static std::vector<std::vector<T>> calculate(const MatrixA& A, const MatrixB& B) {
         int n = A.size();
         std::vector<std::vector<T>> result(n, std::vector<T>(n, 0));
+        WorkspaceScope workspace;
+        multiply(A, B, result);
+        return result;
+    }
 
-        if (n <= 2) {
-            return standardMultiplication(A, B);
+private:
+    // Quadrants of A and B are O(1) views; only the partial products live in the workspace
+    // and are released when the level returns
+    template<typename RowsA, typename RowsB, typename Result>
+    static void multiply(const RowsA& A, const RowsB& B, Result& result) {
+        int n = A.size();
+
+        if (n == 1) {
+            result[0][0] = A[0][0] * B[0][0];
         } else {
+            WorkspaceScope workspace;
             int newSize = n / 2;
-            std::vector<std::vector<T>> 
-                a11(newSize, std::vector<T>(newSize)),
-                a12(newSize, std::vector<T>(newSize)),
-                a21(newSize, std::vector<T>(newSize)),
-                a22(newSize, std::vector<T>(newSize)),
-                b11(newSize, std::vector<T>(newSize)),
-                b12(newSize, std::vector<T>(newSize)),
-                b21(newSize, std::vector<T>(newSize)),
-                b22(newSize, std::vector<T>(newSize));
-
-            splitMatrix(A, a11, 0, 0);
-            splitMatrix(A, a12, 0, newSize);
-            splitMatrix(A, a21, newSize, 0);
-            splitMatrix(A, a22, newSize, newSize);
-
-            splitMatrix(B, b11, 0, 0);
-            splitMatrix(B, b12, 0, newSize);
-            splitMatrix(B, b21, newSize, 0);
-            splitMatrix(B, b22, newSize, newSize);
-
-            auto p1 = calculate(add(a11, a22), add(b11, b22));
-            auto p2 = calculate(add(a21, a22), b11);
-            auto p3 = calculate(a11, subtract(b12, b22));
-            auto p4 = calculate(a22, subtract(b21, b11));
-            auto p5 = calculate(add(a11, a12), b22);
-            auto p6 = calculate(subtract(a21, a11), add(b11, b12));
-            auto p7 = calculate(subtract(a12, a22), add(b21, b22));
-
-            auto c11 = add(subtract(add(p1, p4), p5), p7);
-            auto c12 = add(p3, p5);
-            auto c21 = add(p2, p4);
-            auto c22 = add(subtract(add(p1, p3), p2), p6);
-
-            joinMatrix(c11, result, 0, 0);
-            joinMatrix(c12, result, 0, newSize);
-            joinMatrix(c21, result, newSize, 0);
-            joinMatrix(c22, result, newSize, newSize);
+            auto a11 = subBlock(A, 0, 0, newSize, newSize);
+            auto a12 = subBlock(A, 0, newSize, newSize, newSize);
+            auto a21 = subBlock(A, newSize, 0, newSize, newSize);
+            auto a22 = subBlock(A, newSize, newSize, newSize, newSize);
+            auto b11 = subBlock(B, 0, 0, newSize, newSize);
+            auto b12 = subBlock(B, 0, newSize, newSize, newSize);
+            auto b21 = subBlock(B, newSize, 0, newSize, newSize);
+            auto b22 = subBlock(B, newSize, newSize, newSize, newSize);
+            WorkspaceMatrix<T>
+                left = makeWorkspaceMatrix<T>(newSize, newSize),
+                right = makeWorkspaceMatrix<T>(newSize, newSize);
+
+            multiply(a11, b11, left);
+            multiply(a12, b21, right);
+            add(left, right, result, 0, 0);
+            multiply(a11, b12, left);
+            multiply(a12, b22, right);
+            add(left, right, result, 0, newSize);
+            multiply(a21, b11, left);
+            multiply(a22, b21, right);
+            add(left, right, result, newSize, 0);
+            multiply(a21, b12, left);
+            multiply(a22, b22, right);
+            add(left, right, result, newSize, newSize);
         }
-        return result;
     }
 
-private:
-    static void splitMatrix(const std::vector<std::vector<T>>& source, std::vector<std::vector<T>>& destination, int startX, int startY) {
-        int n = destination.size();
+    template<typename Result>
+    static void add(const WorkspaceMatrix<T>& A, const WorkspaceMatrix<T>& B, Result& destination, int startX, int startY) {
+        int n = A.size();
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < n; j++) {
-                destination[i][j] = source[i + startX][j + startY];
+                destination[i + startX][j + startY] = A[i][j] + B[i][j];
             }
         }
     }
+};
 
-    static void joinMatrix(const std::vector<std::vector<T>>& source, std::vector<std::vector<T>>& destination, int startX, int startY) {
-        int n = source.size();
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                destination[i + startX][j + startY] = source[i][j];
+template<typename T>
+class StrassenMultiplication {
+public:
+    template<RowIndexable<T> MatrixA, RowIndexable<T> MatrixB>
+    static std::vector<std::vector<T>> calculate(const MatrixA& A, const MatrixB& B) {
+        int n = A.size();
+        std::vector<std::vector<T>> result(n, std::vector<T>(n, 0));
+        WorkspaceScope workspace;
+        multiply(A, B, result);
+        return result;
+    }
+
+private:
+    // Quadrants are O(1) views into the operands; operand sums and the seven products live
+    // in the workspace and are released when the level returns, so peak scratch is bounded
+    // by one path of the recursion
+    template<typename RowsA, typename RowsB, typename Result>
+    static void multiply(const RowsA& A, const RowsB& B, Result& result) {
+        int n = A.size();
+
+        if (n <= 2) {
+            standardMultiplication(A, B, result);
+        } else {
+            WorkspaceScope workspace;
+            int newSize = n / 2;
+            auto a11 = subBlock(A, 0, 0, newSize, newSize);
+            auto a12 = subBlock(A, 0, newSize, newSize, newSize);
+            auto a21 = subBlock(A, newSize, 0, newSize, newSize);
+            auto a22 = subBlock(A, newSize, newSize, newSize, newSize);
+            auto b11 = subBlock(B, 0, 0, newSize, newSize);
+            auto b12 = subBlock(B, 0, newSize, newSize, newSize);
+            auto b21 = subBlock(B, newSize, 0, newSize, newSize);
+            auto b22 = subBlock(B, newSize, newSize, newSize, newSize);
+
+            WorkspaceMatrix<T>
+                left = makeWorkspaceMatrix<T>(newSize, newSize),
+                right = makeWorkspaceMatrix<T>(newSize, newSize),
+                p1 = makeWorkspaceMatrix<T>(newSize, newSize),
+                p2 = makeWorkspaceMatrix<T>(newSize, newSize),
+                p3 = makeWorkspaceMatrix<T>(newSize, newSize),
+                p4 = makeWorkspaceMatrix<T>(newSize, newSize),
+                p5 = makeWorkspaceMatrix<T>(newSize, newSize),
+                p6 = makeWorkspaceMatrix<T>(newSize, newSize),
+                p7 = makeWorkspaceMatrix<T>(newSize, newSize);
+
+            add(a11, a22, left);
+            add(b11, b22, right);
+            multiply(left, right, p1);
+            add(a21, a22, left);
+            multiply(left, b11, p2);
+            subtract(b12, b22, right);
+            multiply(a11, right, p3);
+            subtract(b21, b11, right);
+            multiply(a22, right, p4);
+            add(a11, a12, left);
+            multiply(left, b22, p5);
+            subtract(a21, a11, left);
+            add(b11, b12, right);
+            multiply(left, right, p6);
+            subtract(a12, a22, left);
+            add(b21, b22, right);
+            multiply(left, right, p7);
+
+            for (int i = 0; i < newSize; i++) {
+                for (int j = 0; j < newSize; j++) {
+                    result[i][j] = p1[i][j] + p4[i][j] - p5[i][j] + p7[i][j];
+                    result[i][j + newSize] = p3[i][j] + p5[i][j];
+                    result[i + newSize][j] = p2[i][j] + p4[i][j];
+                    result[i + newSize][j + newSize] = p1[i][j] + p3[i][j] - p2[i][j] + p6[i][j];
+                }
             }
         }
     }
 
-    static std::vector<std::vector<T>> add(const std::vector<std::vector<T>>& A, const std::vector<std::vector<T>>& B) {
+    template<typename RowsA, typename RowsB>
+    static void add(const RowsA& A, const RowsB& B, WorkspaceMatrix<T>& result) {
         int n = A.size();
-        std::vector<std::vector<T>> result(n, std::vector<T>(n));
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < n; j++) {
                 result[i][j] = A[i][j] + B[i][j];
             }
         }
-        return result;
     }
 
-    static std::vector<std::vector<T>> subtract(const std::vector<std::vector<T>>& A, const std::vector<std::vector<T>>& B) {
+    template<typename RowsA, typename RowsB>
+    static void subtract(const RowsA& A, const RowsB& B, WorkspaceMatrix<T>& result) {
         int n = A.size();
-        std::vector<std::vector<T>> result(n, std::vector<T>(n));
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < n; j++) {
                 result[i][j] = A[i][j] - B[i][j];
             }
         }
-        return result;
     }
 
-    static std::vector<std::vector<T>> standardMultiplication(const std::vector<std::vector<T>>& A, const std::vector<std::vector<T>>& B) {
+    template<typename RowsA, typename RowsB, typename Result>
+    static void standardMultiplication(const RowsA& A, const RowsB& B, Result& result) {
         int n = A.size();
-        std::vector<std::vector<T>> result(n, std::vector<T>(n, 0));
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < n; j++) {
+                T sum = 0;
                 for (int k = 0; k < n; k++) {
-                    result[i][j] += A[i][k] * B[k][j];
+                    sum += A[i][k] * B[k][j];
                 }
+                result[i][j] = sum;
             }
         }
-        return result;
     }
 };
 
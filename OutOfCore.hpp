@@ -0,0 +1,526 @@
+#ifndef OUT_OF_CORE_HPP
+#define OUT_OF_CORE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Concepts.hpp"
+#include "Executor.hpp"
+#include "MatrixFile.hpp"
+
+#if MATRIX_HAS_MMAP
+
+// Matrices larger than memory, stored on disk as square tiles (MatrixFileLayout::Tiled) and
+// processed by OutOfCoreEngine through a tile cache with a fixed memory budget. While the
+// engine computes on the pinned tiles it reads the next ones as tasks on the current executor.
+
+template<typename T>
+class TiledMatrix {
+public:
+    // Creates (or truncates) `path` as a zero-filled rows x cols matrix
+    TiledMatrix(const std::string& path, std::size_t rows, std::size_t cols, std::size_t tileSize) : path(path) {
+        if (tileSize == 0) {
+            throw std::invalid_argument("Tile size must be positive.");
+        }
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MatrixFileMagic, sizeof(header.magic));
+        header.version = MatrixFileVersion;
+        header.byteOrder = MatrixFileByteOrder;
+        header.dataType = static_cast<std::uint32_t>(matrixFileDataType<T>());
+        header.layout = static_cast<std::uint32_t>(MatrixFileLayout::Tiled);
+        header.rows = rows;
+        header.cols = cols;
+        header.alignment = 4096;
+        header.payloadOffset = header.alignment;
+        header.tileSize = static_cast<std::uint32_t>(tileSize);
+
+        descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (descriptor < 0) {
+            throw std::runtime_error("Cannot create tiled matrix file: " + path);
+        }
+        if (::pwrite(descriptor, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            ::ftruncate(descriptor, static_cast<off_t>(tileOffset(tileRows(), 0))) != 0) {
+            ::close(descriptor);
+            throw std::runtime_error("Cannot size tiled matrix file: " + path);
+        }
+    }
+
+    // Opens an existing tiled matrix file for reading and writing
+    explicit TiledMatrix(const std::string& path) : path(path) {
+        descriptor = ::open(path.c_str(), O_RDWR);
+        if (descriptor < 0) {
+            throw std::runtime_error("Cannot open tiled matrix file: " + path);
+        }
+        if (::pread(descriptor, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            std::memcmp(header.magic, MatrixFileMagic, sizeof(header.magic)) != 0 ||
+            header.byteOrder != MatrixFileByteOrder || header.version != MatrixFileVersion ||
+            header.layout != static_cast<std::uint32_t>(MatrixFileLayout::Tiled) || header.tileSize == 0) {
+            ::close(descriptor);
+            throw std::runtime_error("Not a tiled matrix file: " + path);
+        }
+        if (header.dataType != static_cast<std::uint32_t>(matrixFileDataType<T>())) {
+            ::close(descriptor);
+            throw std::runtime_error("Matrix file element type does not match the requested type: " + path);
+        }
+    }
+
+    template<RowIndexable<T> Rows>
+    static TiledMatrix fromRows(const std::string& path, const Rows& matrix, std::size_t tileSize) {
+        std::size_t rows = matrix.size();
+        std::size_t cols = rows > 0 ? matrix[0].size() : 0;
+        TiledMatrix result(path, rows, cols, tileSize);
+        std::vector<T> tile(result.tileElements());
+        for (std::size_t r = 0; r < result.tileRows(); ++r) {
+            for (std::size_t c = 0; c < result.tileCols(); ++c) {
+                std::fill(tile.begin(), tile.end(), T(0));
+                for (std::size_t i = 0; i < result.tileHeight(r); ++i) {
+                    for (std::size_t j = 0; j < result.tileWidth(c); ++j) {
+                        tile[i * tileSize + j] = matrix[r * tileSize + i][c * tileSize + j];
+                    }
+                }
+                result.writeTile(r, c, tile.data());
+            }
+        }
+        return result;
+    }
+
+    ~TiledMatrix() {
+        if (descriptor >= 0) {
+            ::close(descriptor);
+        }
+    }
+
+    TiledMatrix(const TiledMatrix&) = delete;
+    TiledMatrix& operator=(const TiledMatrix&) = delete;
+
+    TiledMatrix(TiledMatrix&& other) noexcept : header(other.header), path(std::move(other.path)), descriptor(other.descriptor) {
+        other.descriptor = -1;
+    }
+
+    std::size_t rows() const { return header.rows; }
+    std::size_t cols() const { return header.cols; }
+    std::size_t tileSize() const { return header.tileSize; }
+    std::size_t tileRows() const { return (header.rows + header.tileSize - 1) / header.tileSize; }
+    std::size_t tileCols() const { return (header.cols + header.tileSize - 1) / header.tileSize; }
+    std::size_t tileElements() const { return tileSize() * tileSize(); }
+
+    // Rows of tile row r and columns of tile column c that lie inside the matrix
+    std::size_t tileHeight(std::size_t r) const { return std::min(tileSize(), rows() - r * tileSize()); }
+    std::size_t tileWidth(std::size_t c) const { return std::min(tileSize(), cols() - c * tileSize()); }
+
+    // Safe to call from several threads at once
+    void readTile(std::size_t r, std::size_t c, T* out) const {
+        transfer(r, c, [&](std::size_t done, std::size_t size, off_t offset) {
+            return ::pread(descriptor, reinterpret_cast<char*>(out) + done, size, offset);
+        });
+    }
+
+    void writeTile(std::size_t r, std::size_t c, const T* in) {
+        transfer(r, c, [&](std::size_t done, std::size_t size, off_t offset) {
+            return ::pwrite(descriptor, reinterpret_cast<const char*>(in) + done, size, offset);
+        });
+    }
+
+    // Reads the whole matrix into memory; only sensible for matrices that fit
+    std::vector<std::vector<T>> toVectorMatrix() const {
+        std::vector<std::vector<T>> result(rows(), std::vector<T>(cols()));
+        std::vector<T> tile(tileElements());
+        for (std::size_t r = 0; r < tileRows(); ++r) {
+            for (std::size_t c = 0; c < tileCols(); ++c) {
+                readTile(r, c, tile.data());
+                for (std::size_t i = 0; i < tileHeight(r); ++i) {
+                    for (std::size_t j = 0; j < tileWidth(c); ++j) {
+                        result[r * tileSize() + i][c * tileSize() + j] = tile[i * tileSize() + j];
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    std::uint64_t tileOffset(std::size_t r, std::size_t c) const {
+        return header.payloadOffset + (static_cast<std::uint64_t>(r) * tileCols() + c) * tileElements() * sizeof(T);
+    }
+
+    template<typename IO>
+    void transfer(std::size_t r, std::size_t c, IO&& io) const {
+        std::size_t total = tileElements() * sizeof(T);
+        std::size_t done = 0;
+        while (done < total) {
+            ssize_t count = io(done, total - done, static_cast<off_t>(tileOffset(r, c) + done));
+            if (count <= 0) {
+                throw std::runtime_error("I/O error on tiled matrix file: " + path);
+            }
+            done += static_cast<std::size_t>(count);
+        }
+    }
+
+    MatrixFileHeader header{};
+    std::string path;
+    int descriptor = -1;
+};
+
+struct OutOfCoreStats {
+    std::uint64_t tilesRead = 0;
+    std::uint64_t tilesWritten = 0;
+    std::uint64_t prefetchHits = 0;
+    std::size_t peakResidentBytes = 0;
+};
+
+// Tiles resident in memory, at most budget / tile bytes of them. Pinned tiles are never
+// evicted; dirty tiles are written back when they are evicted or flushed. Prefetches are
+// queued on the executor that is current when the cache is created.
+template<typename T>
+class TileCache {
+public:
+    TileCache(std::size_t memoryBudgetBytes, std::size_t tileElements)
+        : tileElements(tileElements), capacity(memoryBudgetBytes / (tileElements * sizeof(T))), executor(&MatrixExecutor::current()) {}
+
+    ~TileCache() {
+        for (auto& entry : entries) {
+            if (entry->loading.valid()) {
+                entry->loading.wait();
+            }
+        }
+    }
+
+    TileCache(TileCache&&) = default;
+
+    std::size_t tileCapacity() const {
+        return capacity;
+    }
+
+    // Pins a tile and returns its buffer. With load = false the tile is about to be
+    // overwritten completely and its old contents are not read.
+    T* acquire(TiledMatrix<T>& matrix, std::size_t r, std::size_t c, bool load = true) {
+        Entry* entry = find(matrix, r, c);
+        if (entry != nullptr) {
+            if (entry->loading.valid()) {
+                finishLoading(*entry);
+                ++stats.prefetchHits;
+            }
+        } else {
+            entry = makeRoom(true);
+            assign(*entry, matrix, r, c);
+            if (load) {
+                matrix.readTile(r, c, entry->data.data());
+                ++stats.tilesRead;
+            }
+        }
+        entry->pins += 1;
+        entry->lastUse = ++clock;
+        return entry->data.data();
+    }
+
+    void release(TiledMatrix<T>& matrix, std::size_t r, std::size_t c, bool dirty = false) {
+        Entry* entry = find(matrix, r, c);
+        entry->pins -= 1;
+        entry->dirty = entry->dirty || dirty;
+    }
+
+    // Starts reading a tile in the background if a slot is free or can be freed without waiting
+    void prefetch(TiledMatrix<T>& matrix, std::size_t r, std::size_t c) {
+        if (find(matrix, r, c) != nullptr) {
+            return;
+        }
+        Entry* entry = makeRoom(false);
+        if (entry == nullptr) {
+            return;
+        }
+        assign(*entry, matrix, r, c);
+        T* buffer = entry->data.data();
+        const TiledMatrix<T>* source = &matrix;
+        entry->loading = executor->submit([source, r, c, buffer] { source->readTile(r, c, buffer); });
+        ++stats.tilesRead;
+    }
+
+    void flush() {
+        for (auto& entry : entries) {
+            writeBack(*entry);
+        }
+    }
+
+    const OutOfCoreStats& statistics() const {
+        return stats;
+    }
+
+private:
+    struct Entry {
+        TiledMatrix<T>* matrix = nullptr;
+        std::size_t r = 0;
+        std::size_t c = 0;
+        std::vector<T> data;
+        std::future<void> loading;
+        int pins = 0;
+        bool dirty = false;
+        std::uint64_t lastUse = 0;
+    };
+
+    Entry* find(TiledMatrix<T>& matrix, std::size_t r, std::size_t c) {
+        for (auto& entry : entries) {
+            if (entry->matrix == &matrix && entry->r == r && entry->c == c) {
+                return entry.get();
+            }
+        }
+        return nullptr;
+    }
+
+    void assign(Entry& entry, TiledMatrix<T>& matrix, std::size_t r, std::size_t c) {
+        entry.matrix = &matrix;
+        entry.r = r;
+        entry.c = c;
+        entry.dirty = false;
+        entry.pins = 0;
+        entry.lastUse = ++clock;
+    }
+
+    // A free slot: a new one while under budget, else the least recently used unpinned tile.
+    // Tiles still being prefetched are only reclaimed when `wait` is set.
+    Entry* makeRoom(bool wait) {
+        if (entries.size() < capacity) {
+            entries.push_back(std::make_unique<Entry>());
+            entries.back()->data.resize(tileElements);
+            stats.peakResidentBytes = std::max(stats.peakResidentBytes, entries.size() * tileElements * sizeof(T));
+            return entries.back().get();
+        }
+
+        Entry* victim = nullptr;
+        for (auto& entry : entries) {
+            if (entry->pins > 0) continue;
+            bool loading = entry->loading.valid() && entry->loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+            if (loading && !wait) continue;
+            if (victim == nullptr || entry->lastUse < victim->lastUse) {
+                victim = entry.get();
+            }
+        }
+        if (victim == nullptr) {
+            if (wait) {
+                throw std::runtime_error("Out-of-core memory budget is too small for the tiles in use.");
+            }
+            return nullptr;
+        }
+        finishLoading(*victim);
+        writeBack(*victim);
+        victim->matrix = nullptr;
+        return victim;
+    }
+
+    // Waits for a pending prefetch of the entry, running queued executor tasks meanwhile so
+    // the read is not stuck behind them when every worker is busy
+    void finishLoading(Entry& entry) {
+        if (!entry.loading.valid()) {
+            return;
+        }
+        while (entry.loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!executor->runOne()) {
+                entry.loading.wait_for(std::chrono::microseconds(200));
+            }
+        }
+        entry.loading.get();
+    }
+
+    void writeBack(Entry& entry) {
+        if (entry.dirty && entry.matrix != nullptr) {
+            finishLoading(entry);
+            entry.matrix->writeTile(entry.r, entry.c, entry.data.data());
+            entry.dirty = false;
+            ++stats.tilesWritten;
+        }
+    }
+
+    std::size_t tileElements;
+    std::size_t capacity;
+    MatrixExecutor* executor;
+    std::vector<std::unique_ptr<Entry>> entries;
+    std::uint64_t clock = 0;
+    OutOfCoreStats stats;
+};
+
+template<typename T>
+class OutOfCoreEngine {
+public:
+    // Three tiles are pinned at a time and two more are kept for prefetching
+    static constexpr std::size_t MinimumTiles = 5;
+
+    explicit OutOfCoreEngine(std::size_t memoryBudgetBytes) : memoryBudget(memoryBudgetBytes) {}
+
+    // C = A * B; all three must share one tile size
+    void multiply(TiledMatrix<T>& A, TiledMatrix<T>& B, TiledMatrix<T>& C) {
+        if (A.cols() != B.rows() || C.rows() != A.rows() || C.cols() != B.cols()) {
+            throw std::invalid_argument("Invalid dimensions for out-of-core multiplication.");
+        }
+        if (A.tileSize() != B.tileSize() || A.tileSize() != C.tileSize()) {
+            throw std::invalid_argument("Out-of-core operands must share one tile size.");
+        }
+        TileCache<T> cache = makeCache(A.tileSize());
+        std::size_t ts = A.tileSize();
+
+        for (std::size_t i = 0; i < C.tileRows(); ++i) {
+            for (std::size_t j = 0; j < C.tileCols(); ++j) {
+                T* c = cache.acquire(C, i, j, false);
+                std::fill(c, c + ts * ts, T(0));
+                for (std::size_t p = 0; p < A.tileCols(); ++p) {
+                    T* a = cache.acquire(A, i, p);
+                    T* b = cache.acquire(B, p, j);
+                    if (p + 1 < A.tileCols()) {
+                        cache.prefetch(A, i, p + 1);
+                        cache.prefetch(B, p + 1, j);
+                    }
+                    multiplyAccumulate(c, a, b, ts, C.tileHeight(i), C.tileWidth(j), A.tileWidth(p));
+                    cache.release(A, i, p);
+                    cache.release(B, p, j);
+                }
+                cache.release(C, i, j, true);
+            }
+        }
+        cache.flush();
+        stats = cache.statistics();
+    }
+
+    // In-place lower Cholesky factor of a symmetric positive definite A (only its lower triangle is read);
+    // the upper triangle is zeroed, as in the in-memory Cholesky policies
+    void cholesky(TiledMatrix<T>& A) {
+        if (A.rows() != A.cols()) {
+            throw std::invalid_argument("Cholesky decomposition requires a square matrix.");
+        }
+        TileCache<T> cache = makeCache(A.tileSize());
+        std::size_t ts = A.tileSize();
+        std::size_t tiles = A.tileRows();
+
+        for (std::size_t k = 0; k < tiles; ++k) {
+            std::size_t nk = A.tileHeight(k);
+            T* diagonal = cache.acquire(A, k, k);
+            factorDiagonal(diagonal, ts, nk);
+
+            for (std::size_t i = k + 1; i < tiles; ++i) {
+                T* panel = cache.acquire(A, i, k);
+                if (i + 1 < tiles) {
+                    cache.prefetch(A, i + 1, k);
+                }
+                solveTransposed(panel, diagonal, ts, A.tileHeight(i), nk);
+                cache.release(A, i, k, true);
+            }
+            cache.release(A, k, k, true);
+
+            for (std::size_t j = k + 1; j < tiles; ++j) {
+                T* right = cache.acquire(A, j, k);
+                for (std::size_t i = j; i < tiles; ++i) {
+                    T* target = cache.acquire(A, i, j);
+                    T* left = cache.acquire(A, i, k);
+                    if (i + 1 < tiles) {
+                        cache.prefetch(A, i + 1, j);
+                        cache.prefetch(A, i + 1, k);
+                    }
+                    subtractProductTransposed(target, left, right, ts, A.tileHeight(i), A.tileHeight(j), nk);
+                    cache.release(A, i, k);
+                    cache.release(A, i, j, true);
+                }
+                cache.release(A, j, k);
+            }
+        }
+
+        for (std::size_t i = 0; i < tiles; ++i) {
+            for (std::size_t j = i + 1; j < tiles; ++j) {
+                T* upper = cache.acquire(A, i, j, false);
+                std::fill(upper, upper + ts * ts, T(0));
+                cache.release(A, i, j, true);
+            }
+        }
+        cache.flush();
+        stats = cache.statistics();
+    }
+
+    // Tile traffic of the last operation
+    const OutOfCoreStats& statistics() const {
+        return stats;
+    }
+
+private:
+    TileCache<T> makeCache(std::size_t tileSize) const {
+        TileCache<T> cache(memoryBudget, tileSize * tileSize);
+        if (cache.tileCapacity() < MinimumTiles) {
+            throw std::invalid_argument("Out-of-core memory budget must hold at least " + std::to_string(MinimumTiles) + " tiles.");
+        }
+        return cache;
+    }
+
+    // c += a * b on the m x n, m x k and k x n corners of tiles with row stride ts
+    static void multiplyAccumulate(T* c, const T* a, const T* b, std::size_t ts, std::size_t m, std::size_t n, std::size_t k) {
+        for (std::size_t i = 0; i < m; ++i) {
+            for (std::size_t p = 0; p < k; ++p) {
+                T value = a[i * ts + p];
+                for (std::size_t j = 0; j < n; ++j) {
+                    c[i * ts + j] += value * b[p * ts + j];
+                }
+            }
+        }
+    }
+
+    // In-place Cholesky of the leading n x n block, zeroing its upper triangle
+    static void factorDiagonal(T* a, std::size_t ts, std::size_t n) {
+        for (std::size_t j = 0; j < n; ++j) {
+            T sum = a[j * ts + j];
+            for (std::size_t p = 0; p < j; ++p) {
+                sum -= a[j * ts + p] * a[j * ts + p];
+            }
+            if (!(sum > 0)) {
+                throw std::runtime_error("Matrix is not positive definite.");
+            }
+            T pivot = std::sqrt(sum);
+            a[j * ts + j] = pivot;
+            for (std::size_t i = j + 1; i < n; ++i) {
+                T value = a[i * ts + j];
+                for (std::size_t p = 0; p < j; ++p) {
+                    value -= a[i * ts + p] * a[j * ts + p];
+                }
+                a[i * ts + j] = value / pivot;
+            }
+            for (std::size_t i = 0; i < j; ++i) {
+                a[i * ts + j] = 0;
+            }
+        }
+    }
+
+    // panel := panel * L^-T for the m x n panel and the n x n lower factor L
+    static void solveTransposed(T* panel, const T* L, std::size_t ts, std::size_t m, std::size_t n) {
+        for (std::size_t i = 0; i < m; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                T value = panel[i * ts + j];
+                for (std::size_t p = 0; p < j; ++p) {
+                    value -= panel[i * ts + p] * L[j * ts + p];
+                }
+                panel[i * ts + j] = value / L[j * ts + j];
+            }
+        }
+    }
+
+    // target -= left * right^T for m x k left, n x k right
+    static void subtractProductTransposed(T* target, const T* left, const T* right, std::size_t ts, std::size_t m, std::size_t n, std::size_t k) {
+        for (std::size_t i = 0; i < m; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                T sum = 0;
+                for (std::size_t p = 0; p < k; ++p) {
+                    sum += left[i * ts + p] * right[j * ts + p];
+                }
+                target[i * ts + j] -= sum;
+            }
+        }
+    }
+
+    std::size_t memoryBudget;
+    OutOfCoreStats stats;
+};
+
+#endif // MATRIX_HAS_MMAP
+
+#endif // OUT_OF_CORE_HPP
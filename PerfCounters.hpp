@@ -0,0 +1,526 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Executor.hpp"
+#include "Instrumentation.hpp"
+
+#if defined(__linux__) && !defined(MATRIX_DISABLE_PERF_COUNTERS)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define MATRIX_HAS_PERF_EVENTS 1
+#else
+#define MATRIX_HAS_PERF_EVENTS 0
+#endif
+
+// Hardware counters read through Linux perf_event_open. Every counter is optional:
+// when the kernel, the PMU or perf_event_paranoid refuses one, it is reported as
+// unavailable and the rest keep working. Off Linux everything is unavailable.
+
+enum class PerfCounter {
+    Cycles,
+    Instructions,
+    L1DataMisses,
+    LastLevelCacheMisses,
+    BranchMisses,
+    FloatingPointOps,
+    TaskClock,
+    Count
+};
+
+constexpr std::size_t PerfCounterCount = static_cast<std::size_t>(PerfCounter::Count);
+
+inline const char* perfCounterName(PerfCounter counter) {
+    switch (counter) {
+        case PerfCounter::Cycles: return "cycles";
+        case PerfCounter::Instructions: return "instructions";
+        case PerfCounter::L1DataMisses: return "l1d_misses";
+        case PerfCounter::LastLevelCacheMisses: return "llc_misses";
+        case PerfCounter::BranchMisses: return "branch_misses";
+        case PerfCounter::FloatingPointOps: return "fp_ops";
+        case PerfCounter::TaskClock: return "task_clock_ns";
+        default: return "unknown";
+    }
+}
+
+struct PerfSample {
+    std::array<std::uint64_t, PerfCounterCount> values{};
+    std::array<bool, PerfCounterCount> available{};
+
+    std::uint64_t operator[](PerfCounter counter) const {
+        return values[static_cast<std::size_t>(counter)];
+    }
+
+    bool has(PerfCounter counter) const {
+        return available[static_cast<std::size_t>(counter)];
+    }
+
+    bool any() const {
+        for (bool value : available) {
+            if (value) return true;
+        }
+        return false;
+    }
+
+    PerfSample& operator+=(const PerfSample& other) {
+        for (std::size_t i = 0; i < PerfCounterCount; ++i) {
+            values[i] += other.values[i];
+            available[i] = available[i] || other.available[i];
+        }
+        return *this;
+    }
+
+    // Difference to an earlier read of the same counters
+    PerfSample& operator-=(const PerfSample& earlier) {
+        for (std::size_t i = 0; i < PerfCounterCount; ++i) {
+            values[i] = available[i] ? values[i] - earlier.values[i] : 0;
+        }
+        return *this;
+    }
+};
+
+// One group of counters for the calling thread, opened once and read twice per measurement.
+class PerfCounterGroup {
+public:
+    PerfCounterGroup() {
+        descriptors.fill(-1);
+#if MATRIX_HAS_PERF_EVENTS
+        open(PerfCounter::Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open(PerfCounter::Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open(PerfCounter::L1DataMisses, PERF_TYPE_HW_CACHE,
+             PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        open(PerfCounter::LastLevelCacheMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        open(PerfCounter::BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+
+        // There is no portable FP event; MATRIX_PERF_FP_EVENT takes a raw, model-specific
+        // encoding (e.g. 0x1c7 for FP_ARITH_INST_RETIRED.SCALAR_DOUBLE on recent Intel cores).
+        if (const char* raw = std::getenv("MATRIX_PERF_FP_EVENT")) {
+            open(PerfCounter::FloatingPointOps, PERF_TYPE_RAW, std::strtoull(raw, nullptr, 0));
+        }
+
+        // On-CPU time is a software event, so it still works in VMs without a PMU
+        open(PerfCounter::TaskClock, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+
+        if (leader >= 0) {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    ~PerfCounterGroup() {
+#if MATRIX_HAS_PERF_EVENTS
+        for (int descriptor : descriptors) {
+            if (descriptor >= 0) {
+                close(descriptor);
+            }
+        }
+#endif
+    }
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    static PerfCounterGroup& forThisThread() {
+        thread_local PerfCounterGroup group;
+        return group;
+    }
+
+    bool available() const {
+        return leader >= 0;
+    }
+
+    bool available(PerfCounter counter) const {
+        return descriptors[static_cast<std::size_t>(counter)] >= 0;
+    }
+
+    // Current running totals, scaled up if the kernel had to multiplex the group.
+    PerfSample read() const {
+        PerfSample sample;
+#if MATRIX_HAS_PERF_EVENTS
+        if (leader < 0) {
+            return sample;
+        }
+        // nr, time_enabled, time_running, then one value per member in opening order
+        std::uint64_t buffer[3 + PerfCounterCount] = {};
+        if (::read(leader, buffer, sizeof(buffer)) <= 0) {
+            return sample;
+        }
+        std::uint64_t members = buffer[0];
+        double scale = (buffer[2] > 0 && buffer[2] < buffer[1]) ? static_cast<double>(buffer[1]) / buffer[2] : 1.0;
+        for (std::uint64_t i = 0; i < members && i < memberCount; ++i) {
+            std::size_t counter = memberCounters[i];
+            sample.values[counter] = static_cast<std::uint64_t>(buffer[3 + i] * scale);
+            sample.available[counter] = true;
+        }
+#endif
+        return sample;
+    }
+
+private:
+#if MATRIX_HAS_PERF_EVENTS
+    void open(PerfCounter counter, std::uint32_t type, std::uint64_t config) {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = type;
+        attributes.config = config;
+        attributes.disabled = leader < 0 ? 1 : 0;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        int descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0));
+        if (descriptor < 0) {
+            return;
+        }
+        if (leader < 0) {
+            leader = descriptor;
+        }
+        descriptors[static_cast<std::size_t>(counter)] = descriptor;
+        memberCounters[memberCount++] = static_cast<std::size_t>(counter);
+    }
+#endif
+
+    int leader = -1;
+    std::array<int, PerfCounterCount> descriptors{};
+    std::array<std::size_t, PerfCounterCount> memberCounters{};
+    std::size_t memberCount = 0;
+};
+
+// Counters of one measurement: those of the thread that opened it, plus those of the executor
+// workers while they run tasks pushed from that thread, or from those tasks, while it was
+// open. Each such task is read before and after on the worker that runs it, so work for
+// other measurements running on the same workers is not counted; tasks still running when
+// the measurement is read are read through the worker's group as they stand. Measurements
+// nest: a task is added to its own measurement and every enclosing one that was not already
+// counting the thread running it, and taken back out of the measurements that were counting
+// that thread but are not its own (a thread waiting for its tasks helps run other queued
+// ones). The thread that opens a measurement installs it as its
+// TaskObserver, which keeps it alive until close(), and queued tasks keep it alive until
+// they have run.
+class PerfAttribution : public TaskObserver, public std::enable_shared_from_this<PerfAttribution> {
+public:
+    // Opens a measurement nested in the calling thread's current one
+    static PerfAttribution& open() {
+        auto attribution = std::make_shared<PerfAttribution>(TaskObserver::current());
+        PerfAttribution& opened = *attribution;
+        TaskObserver::install(std::move(attribution));
+        opened.begin = PerfCounterGroup::forThisThread().read();
+        return opened;
+    }
+
+    explicit PerfAttribution(std::shared_ptr<TaskObserver> enclosing)
+        : enclosing(std::move(enclosing)), parent(dynamic_cast<PerfAttribution*>(this->enclosing.get())) {}
+
+    // On the opening thread: its counters since open() plus those of the tasks so far
+    PerfSample elapsed() const {
+        PerfSample sample = PerfCounterGroup::forThisThread().read();
+        sample -= begin;
+        std::lock_guard<std::mutex> lock(mutex);
+        sample += finished;
+        sample -= lent;
+        for (const RunningTask* task : running) {
+            sample += task->progress();
+        }
+        return sample;
+    }
+
+    // On the opening thread, after the measurements opened inside it are closed. This may
+    // destroy the measurement.
+    void close() {
+        TaskObserver::install(enclosing);
+    }
+
+    void run(const std::function<void()>& task) override {
+        PerfAttribution* current = dynamic_cast<PerfAttribution*>(TaskObserver::current().get());
+        if (counts(current, this)) {
+            task();
+            return;
+        }
+        RunningTask started{&PerfCounterGroup::forThisThread(), {}};
+        started.begin = started.group->read();
+        forEachUncounted(this, current, [&started](PerfAttribution& measurement) {
+            measurement.running.push_back(&started);
+        });
+
+        std::shared_ptr<TaskObserver> previous = TaskObserver::install(shared_from_this());
+        try {
+            task();
+        } catch (...) {
+            TaskObserver::install(std::move(previous));
+            settle(current, started);
+            throw;
+        }
+        TaskObserver::install(std::move(previous));
+        settle(current, started);
+    }
+
+private:
+    // A group belongs to the worker running the task, and stays open while the task is listed
+    struct RunningTask {
+        const PerfCounterGroup* group;
+        PerfSample begin;
+
+        PerfSample progress() const {
+            PerfSample sample = group->read();
+            sample -= begin;
+            return sample;
+        }
+    };
+
+    // True if a thread whose current measurement is `current` already counts for `measurement`
+    static bool counts(const PerfAttribution* current, const PerfAttribution* measurement) {
+        for (; current != nullptr; current = current->parent) {
+            if (current == measurement) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Calls f, under the measurement's lock, for `innermost` and the measurements enclosing it
+    // that a thread whose current measurement is `current` does not count for
+    template<typename F>
+    static void forEachUncounted(PerfAttribution* innermost, const PerfAttribution* current, F f) {
+        for (PerfAttribution* measurement = innermost; measurement != nullptr && !counts(current, measurement); measurement = measurement->parent) {
+            std::lock_guard<std::mutex> lock(measurement->mutex);
+            f(*measurement);
+        }
+    }
+
+    void settle(PerfAttribution* current, const RunningTask& task) {
+        PerfSample sample = task.progress();
+        forEachUncounted(this, current, [&task, &sample](PerfAttribution& measurement) {
+            measurement.running.erase(std::find(measurement.running.begin(), measurement.running.end(), &task));
+            measurement.finished += sample;
+        });
+        forEachUncounted(current, this, [&sample](PerfAttribution& measurement) {
+            measurement.lent += sample;
+        });
+    }
+
+    std::shared_ptr<TaskObserver> enclosing;
+    PerfAttribution* parent;
+    PerfSample begin;
+    mutable std::mutex mutex;
+    PerfSample finished;
+    PerfSample lent;
+    std::vector<const RunningTask*> running;
+};
+
+// Counters between construction and elapsed() of the constructing thread and of the executor
+// work it hands out in that time (see PerfAttribution)
+class PerfMeasurement {
+public:
+    PerfMeasurement() : attribution(PerfAttribution::open()) {}
+
+    ~PerfMeasurement() {
+        attribution.close();
+    }
+
+    PerfMeasurement(const PerfMeasurement&) = delete;
+    PerfMeasurement& operator=(const PerfMeasurement&) = delete;
+
+    PerfSample elapsed() const {
+        return attribution.elapsed();
+    }
+
+private:
+    PerfAttribution& attribution;
+};
+
+struct PerfStats {
+    std::uint64_t calls = 0;
+    double estimatedFlops = 0;
+    PerfSample counters;
+};
+
+// Accumulated counters per operation and matrix size ("Householder<double> 64x64"). Each
+// thread records into its own shard, keyed by the address of the operation name and the
+// size, so a scope neither builds a string nor contends with other threads; snapshot()
+// merges the shards by name. Operation names must stay valid for the life of the program,
+// as string literals and the names policyName() returns do.
+class PerfRegistry {
+public:
+    static PerfRegistry& instance() {
+        static PerfRegistry registry;
+        return registry;
+    }
+
+    void record(std::string_view operation, int rows, int cols, double flops, const PerfSample& sample) {
+        Shard& shard = localShard();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        PerfStats& entry = shard.stats[Key{operation.data(), operation.size(), rows, cols}];
+        entry.calls += 1;
+        entry.estimatedFlops += flops;
+        entry.counters += sample;
+    }
+
+    std::map<std::string, PerfStats> snapshot() const {
+        std::map<std::string, PerfStats> merged;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> shardLock(shard->mutex);
+            for (const auto& [key, entry] : shard->stats) {
+                std::string name = std::string(key.operation, key.length) + " " + std::to_string(key.rows) + "x" + std::to_string(key.cols);
+                PerfStats& total = merged[name];
+                total.calls += entry.calls;
+                total.estimatedFlops += entry.estimatedFlops;
+                total.counters += entry.counters;
+            }
+        }
+        return merged;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> shardLock(shard->mutex);
+            shard->stats.clear();
+        }
+    }
+
+    static void print(std::ostream& os, const std::map<std::string, PerfStats>& snapshot) {
+        os << std::left << std::setw(48) << "operation" << std::right << std::setw(8) << "calls";
+        for (std::size_t i = 0; i < PerfCounterCount; ++i) {
+            os << std::setw(16) << perfCounterName(static_cast<PerfCounter>(i));
+        }
+        os << std::setw(8) << "IPC" << "\n";
+        for (const auto& [name, entry] : snapshot) {
+            os << std::left << std::setw(48) << name << std::right << std::setw(8) << entry.calls;
+            for (std::size_t i = 0; i < PerfCounterCount; ++i) {
+                if (entry.counters.available[i]) {
+                    os << std::setw(16) << entry.counters.values[i];
+                } else {
+                    os << std::setw(16) << "n/a";
+                }
+            }
+            if (entry.counters.has(PerfCounter::Cycles) && entry.counters.has(PerfCounter::Instructions) && entry.counters[PerfCounter::Cycles] > 0) {
+                os << std::setw(8) << std::fixed << std::setprecision(2)
+                   << static_cast<double>(entry.counters[PerfCounter::Instructions]) / entry.counters[PerfCounter::Cycles] << std::defaultfloat;
+            } else {
+                os << std::setw(8) << "n/a";
+            }
+            os << "\n";
+        }
+    }
+
+private:
+    struct Key {
+        const char* operation;
+        std::size_t length;
+        int rows;
+        int cols;
+
+        bool operator<(const Key& other) const {
+            return std::tie(operation, length, rows, cols) < std::tie(other.operation, other.length, other.rows, other.cols);
+        }
+    };
+
+    // Only snapshot() and reset() take a shard's mutex from another thread
+    struct Shard {
+        std::mutex mutex;
+        std::map<Key, PerfStats> stats;
+    };
+
+    PerfRegistry() = default;
+
+    // Shards outlive their threads, so counts recorded by finished workers are kept
+    Shard& localShard() {
+        thread_local Shard* shard = nullptr;
+        if (shard == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex);
+            shards.push_back(std::make_unique<Shard>());
+            shard = shards.back().get();
+        }
+        return *shard;
+    }
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Shard>> shards;
+};
+
+#ifdef MATRIX_DISABLE_INSTRUMENTATION
+
+using PerfProfiler = NoInstrumentation;
+
+#else
+
+// Instrumentation that records everything OperationProfiler does plus hardware counters,
+// attributed to the operation and the matrix size. The counters include the executor tasks
+// the scope's thread hands out while it is open (see PerfAttribution).
+class PerfProfiler {
+public:
+    class Scope {
+    public:
+        constexpr Scope(std::string_view name, double flops = 0, int rows = 0, int cols = 0)
+            : timing(name, flops, rows, cols), name(name), flops(flops), rows(rows), cols(cols) {
+            if (!std::is_constant_evaluated()) {
+                attribution = &PerfAttribution::open();
+            }
+        }
+
+        constexpr ~Scope() {
+            if (!std::is_constant_evaluated()) {
+                finish();
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        constexpr void addBytesAllocated(std::size_t bytes) {
+            timing.addBytesAllocated(bytes);
+        }
+
+        constexpr void addBytesCopied(std::size_t bytes) {
+            timing.addBytesCopied(bytes);
+        }
+
+    private:
+        void finish() {
+            PerfSample sample = attribution->elapsed();
+            attribution->close();
+            if (!sample.any()) {
+                return;
+            }
+            PerfRegistry::instance().record(name, rows, cols, flops, sample);
+        }
+
+        OperationProfiler::Scope timing;
+        std::string_view name;
+        double flops = 0;
+        int rows = 0;
+        int cols = 0;
+        PerfAttribution* attribution = nullptr;
+    };
+};
+
+#endif // MATRIX_DISABLE_INSTRUMENTATION
+
+template<typename Base>
+struct PerfProfiledPolicies : Base {
+    using Instrumentation = PerfProfiler;
+};
+
+#endif // PERF_COUNTERS_HPP
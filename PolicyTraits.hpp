@@ -0,0 +1,87 @@
+#ifndef POLICY_TRAITS_HPP
+#define POLICY_TRAITS_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "Executor.hpp"
+#include "Instrumentation.hpp"
+
+// Optional members of a policy set. A custom policy struct that does not declare
+// one of these members keeps compiling and gets the default shown here.
+
+template<typename Policies>
+constexpr int fixedSizeKernelLimit() {
+    if constexpr (requires { Policies::FixedSizeKernelLimit; }) {
+        return Policies::FixedSizeKernelLimit;
+    } else {
+        return 8;
+    }
+}
+
+// Matrices whose elements take more bytes than this live on the heap (see MatrixStorage.hpp)
+template<typename Policies>
+constexpr std::size_t heapStorageBytes() {
+    if constexpr (requires { Policies::HeapStorageBytes; }) {
+        return Policies::HeapStorageBytes;
+    } else {
+        return 16384;
+    }
+}
+
+// Where policies take their scratch memory from; nullptr means the thread-local workspace arena
+template<typename Policies>
+std::pmr::memory_resource* policyWorkspaceResource() {
+    if constexpr (requires { Policies::workspaceResource(); }) {
+        return Policies::workspaceResource();
+    } else {
+        return nullptr;
+    }
+}
+
+// The thread pool for parallel policies and the asynchronous methods; nullptr means
+// MatrixExecutor::shared()
+template<typename Policies>
+MatrixExecutor* policyExecutor() {
+    if constexpr (requires { Policies::executor(); }) {
+        return Policies::executor();
+    } else {
+        return nullptr;
+    }
+}
+
+// Kernels for products with lazily transposed operands (nt, tn, tt); void means such
+// products materialize the transpose and go through the MultiplicationPolicy
+template<typename Policies>
+struct PolicyTransposedMultiplication {
+    using type = void;
+};
+
+template<typename Policies> requires requires { typename Policies::TransposedMultiplicationPolicy; }
+struct PolicyTransposedMultiplication<Policies> {
+    using type = typename Policies::TransposedMultiplicationPolicy;
+};
+
+// Kernel for the symmetric products A^T * A and A * A^T (ata, aat); void means they are
+// computed as general products with a transposed operand
+template<typename Policies>
+struct PolicySymmetricRankK {
+    using type = void;
+};
+
+template<typename Policies> requires requires { typename Policies::SymmetricRankKPolicy; }
+struct PolicySymmetricRankK<Policies> {
+    using type = typename Policies::SymmetricRankKPolicy;
+};
+
+template<typename Policies>
+struct PolicyInstrumentation {
+    using type = NoInstrumentation;
+};
+
+template<typename Policies> requires requires { typename Policies::Instrumentation; }
+struct PolicyInstrumentation<Policies> {
+    using type = typename Policies::Instrumentation;
+};
+
+#endif // POLICY_TRAITS_HPP
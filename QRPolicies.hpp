@@ -3,12 +3,20 @@
 
 #include<tuple>
 #include <vector>
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
+
+#include "Concepts.hpp"
+#include "MatrixView.hpp"
+#include "TaskGraph.hpp"
+#include "Workspace.hpp"
 
 template<typename T>
 class GramSchmidt {
 public:
-    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> calculate(const std::vector<std::vector<T>>& matrix) {
+    template<RowIndexable<T> Rows>
+    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> calculate(const Rows& matrix) {
         int rows = matrix.size();
         int cols = matrix[0].size();
 
@@ -49,7 +57,8 @@ public:
 template<typename T>
 class Householder {
 public:
-    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> calculate(const std::vector<std::vector<T>>& matrix) {
+    template<RowIndexable<T> Rows>
+    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> calculate(const Rows& matrix) {
         int rows = matrix.size();
         int cols = matrix[0].size();
 
@@ -58,22 +67,26 @@ public:
             Q[i][i] = 1;
         }
 
-        std::vector<std::vector<T>> R = matrix;
+        std::vector<std::vector<T>> R = denseRows<T>(matrix);
+
+        // One reflector buffer for all columns; column k uses its first rows - k entries
+        WorkspaceScope workspace;
+        WorkspaceVector<T> x = makeWorkspaceVector<T>(rows);
 
         for (int k = 0; k < cols && k < rows - 1; ++k) {
-            std::vector<T> x(rows - k, 0);
+            int length = rows - k;
             for (int i = k; i < rows; ++i) {
                 x[i - k] = R[i][k];
             }
 
-            T norm_x = norm(x);
+            T norm_x = norm(x, length);
             if (norm_x == 0) continue;
 
             x[0] += (x[0] >= 0 ? norm_x : -norm_x);
-            T norm_v = norm(x);
+            T norm_v = norm(x, length);
 
-            for (T& element : x) {
-                element /= norm_v;
+            for (int i = 0; i < length; ++i) {
+                x[i] /= norm_v;
             }
 
             for (int j = k; j < cols; ++j) {
@@ -96,20 +109,14 @@ public:
             }
         }
 
-        for (int i = 0; i < rows; ++i) {
-            for (int j = i + 1; j < rows; ++j) {
-                std::swap(Q[i][j], Q[j][i]);
-            }
-        }
-
         return {Q, R};
     }
 
 private:
-    static T norm(const std::vector<T>& vec) {
+    static T norm(const WorkspaceVector<T>& vec, int length) {
         T sum = 0;
-        for (T val : vec) {
-            sum += val * val;
+        for (int i = 0; i < length; ++i) {
+            sum += vec[i] * vec[i];
         }
         return std::sqrt(sum);
     }
@@ -118,11 +125,12 @@ private:
 template<typename T>
 class Givens {
 public:
-    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> calculate(const std::vector<std::vector<T>>& matrix) {
+    template<RowIndexable<T> Rows>
+    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> calculate(const Rows& matrix) {
         int rows = matrix.size();
         int cols = matrix[0].size();
 
-        std::vector<std::vector<T>> R = matrix;
+        std::vector<std::vector<T>> R = denseRows<T>(matrix);
         std::vector<std::vector<T>> Q(rows, std::vector<T>(rows, 0));
         for (int i = 0; i < rows; ++i) {
             Q[i][i] = 1;
@@ -141,8 +149,8 @@ public:
                     for (int k = 0; k < cols; ++k) {
                         T tmp1 = R[i - 1][k];
                         T tmp2 = R[i][k];
-                        R[i - 1][k] = c * tmp1 + s * tmp2;
-                        R[i][k] = -s * tmp1 + c * tmp2;
+                        R[i - 1][k] = c * tmp1 - s * tmp2;
+                        R[i][k] = s * tmp1 + c * tmp2;
                     }
 
                     for (int k = 0; k < rows; ++k) {
@@ -155,17 +163,355 @@ public:
             }
         }
 
+        return {Q, R};
+    }
+};
+
+
+// Householder QR over TileSize x TileSize tiles as a TaskGraph, with PLASMA's flat reduction
+// tree: factor the diagonal tile (geqrt) and apply its reflectors along the tile row (unmqr),
+// then annihilate each tile below the diagonal against the triangle above it (tsqrt) and
+// apply those reflectors to the pair of tile rows (tsmqr). Q is formed by applying all
+// reflectors in reverse to the identity, in the same graph, so forming Q overlaps the end of
+// the factorization. Returns Q (rows x rows) and R (rows x cols) like Householder. The tile
+// size is clamped to the larger dimension and edge tiles are worked on at their real size.
+template<typename T, int TileSize = 128>
+class TiledQR {
+public:
+    template<RowIndexable<T> Rows>
+    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> calculate(const Rows& matrix) {
+        int rows = matrix.size();
+        int cols = rows > 0 ? matrix[0].size() : 0;
+        int ld = std::min(TileSize, std::max({rows, cols, 1}));
+        TileGrid<T> A(matrix, ld);
+        int tilesDown = A.tileRows();
+        int tilesAcross = A.tileCols();
+        int steps = std::min(tilesDown, tilesAcross);
+        // Q shares A's tile size so that its tile rows line up with A's
+        TileGrid<T> Q(rows, rows, ld);
         for (int i = 0; i < rows; ++i) {
-            for (int j = i + 1; j < rows; ++j) {
-                std::swap(Q[i][j], Q[j][i]);
+            Q(i, i) = T(1);
+        }
+        std::vector<T> taus(static_cast<std::size_t>(tilesDown) * tilesAcross * ld, T(0));
+        auto tau = [&](int i, int j) {
+            return taus.data() + (static_cast<std::size_t>(i) * tilesAcross + j) * ld;
+        };
+        TaskGraph graph;
+
+        for (int k = 0; k < steps; ++k) {
+            T* Akk = A.tile(k, k);
+            T* tauKk = tau(k, k);
+            int hk = A.tileHeight(k);
+            int wk = A.tileWidth(k);
+            int reflectors = std::min(hk, wk);
+            graph.add([=] { geqrt(Akk, tauKk, ld, hk, wk); }, {TaskGraph::writes(Akk)});
+            for (int j = k + 1; j < tilesAcross; ++j) {
+                T* Akj = A.tile(k, j);
+                int wj = A.tileWidth(j);
+                graph.add([=] { unmqr(Akk, tauKk, Akj, ld, hk, reflectors, wj, false); }, {TaskGraph::reads(Akk), TaskGraph::writes(Akj)});
+            }
+            for (int m = k + 1; m < tilesDown; ++m) {
+                T* Amk = A.tile(m, k);
+                T* tauMk = tau(m, k);
+                int hm = A.tileHeight(m);
+                graph.add([=] { tsqrt(Akk, Amk, tauMk, ld, hm, wk); }, {TaskGraph::writes(Akk), TaskGraph::writes(Amk)});
+                for (int j = k + 1; j < tilesAcross; ++j) {
+                    T* Akj = A.tile(k, j);
+                    T* Amj = A.tile(m, j);
+                    int wj = A.tileWidth(j);
+                    graph.add([=] { tsmqr(Akj, Amj, Amk, tauMk, ld, hm, wk, wj, false); }, {TaskGraph::reads(Amk), TaskGraph::writes(Akj), TaskGraph::writes(Amj)});
+                }
             }
         }
 
-        return {Q, R};
+        for (int k = steps - 1; k >= 0; --k) {
+            int wk = A.tileWidth(k);
+            for (int m = tilesDown - 1; m > k; --m) {
+                T* Amk = A.tile(m, k);
+                T* tauMk = tau(m, k);
+                int hm = A.tileHeight(m);
+                for (int j = 0; j < tilesDown; ++j) {
+                    T* Qkj = Q.tile(k, j);
+                    T* Qmj = Q.tile(m, j);
+                    int wj = Q.tileWidth(j);
+                    graph.add([=] { tsmqr(Qkj, Qmj, Amk, tauMk, ld, hm, wk, wj, true); }, {TaskGraph::reads(Amk), TaskGraph::writes(Qkj), TaskGraph::writes(Qmj)});
+                }
+            }
+            T* Akk = A.tile(k, k);
+            T* tauKk = tau(k, k);
+            int hk = A.tileHeight(k);
+            int reflectors = std::min(hk, wk);
+            for (int j = 0; j < tilesDown; ++j) {
+                T* Qkj = Q.tile(k, j);
+                int wj = Q.tileWidth(j);
+                graph.add([=] { unmqr(Akk, tauKk, Qkj, ld, hk, reflectors, wj, true); }, {TaskGraph::reads(Akk), TaskGraph::writes(Qkj)});
+            }
+        }
+        graph.run();
+
+        std::vector<std::vector<T>> R = A.toVectorMatrix();
+        for (int i = 0; i < static_cast<int>(R.size()); ++i) {
+            std::fill(R[i].begin(), R[i].begin() + std::min<int>(i, R[i].size()), T(0));
+        }
+        return {Q.toVectorMatrix(), R};
+    }
+
+private:
+    // Reflector I - tau * v * v^T with v = (1, x / scale) that maps (alpha, x) to (beta, 0);
+    // tau = 0 when x is already zero. Returns beta and leaves 1 / (alpha - beta) in scale.
+    static T reflector(T alpha, T xNormSquared, T& tau, T& scale) {
+        if (xNormSquared == 0) {
+            tau = 0;
+            scale = 0;
+            return alpha;
+        }
+        T norm = std::sqrt(alpha * alpha + xNormSquared);
+        T beta = alpha >= 0 ? -norm : norm;
+        tau = (beta - alpha) / beta;
+        scale = 1 / (alpha - beta);
+        return beta;
+    }
+
+    // The kernels work on tiles with row stride ld; the sizes are the extents inside the matrix
+
+    // QR of the rows x cols tile A in place: R on and above the diagonal, reflectors below it
+    static void geqrt(T* A, T* tau, int ld, int rows, int cols) {
+        for (int j = 0; j < std::min(rows, cols); ++j) {
+            T xNormSquared = 0;
+            for (int i = j + 1; i < rows; ++i) {
+                xNormSquared += A[i * ld + j] * A[i * ld + j];
+            }
+            T scale;
+            A[j * ld + j] = reflector(A[j * ld + j], xNormSquared, tau[j], scale);
+            for (int i = j + 1; i < rows; ++i) {
+                A[i * ld + j] *= scale;
+            }
+            if (tau[j] == 0) {
+                continue;
+            }
+            for (int c = j + 1; c < cols; ++c) {
+                T w = A[j * ld + c];
+                for (int i = j + 1; i < rows; ++i) {
+                    w += A[i * ld + j] * A[i * ld + c];
+                }
+                A[j * ld + c] -= tau[j] * w;
+                for (int i = j + 1; i < rows; ++i) {
+                    A[i * ld + c] -= tau[j] * A[i * ld + j] * w;
+                }
+            }
+        }
+    }
+
+    // C = H_r-1 ... H_0 * C with the r reflectors geqrt left in the h-row tile V, or
+    // H_0 ... H_r-1 * C when reversed; C has h rows and `cols` columns
+    static void unmqr(const T* V, const T* tau, T* C, int ld, int h, int r, int cols, bool reverse) {
+        for (int step = 0; step < r; ++step) {
+            int j = reverse ? r - 1 - step : step;
+            if (tau[j] == 0) {
+                continue;
+            }
+            for (int c = 0; c < cols; ++c) {
+                T w = C[j * ld + c];
+                for (int i = j + 1; i < h; ++i) {
+                    w += V[i * ld + j] * C[i * ld + c];
+                }
+                C[j * ld + c] -= tau[j] * w;
+                for (int i = j + 1; i < h; ++i) {
+                    C[i * ld + c] -= tau[j] * V[i * ld + j] * w;
+                }
+            }
+        }
+    }
+
+    // QR of the n x n triangle R stacked on the m x n tile A; R is updated above its diagonal
+    // only and the reflectors replace A
+    static void tsqrt(T* R, T* A, T* tau, int ld, int m, int n) {
+        for (int j = 0; j < n; ++j) {
+            T xNormSquared = 0;
+            for (int i = 0; i < m; ++i) {
+                xNormSquared += A[i * ld + j] * A[i * ld + j];
+            }
+            T scale;
+            R[j * ld + j] = reflector(R[j * ld + j], xNormSquared, tau[j], scale);
+            for (int i = 0; i < m; ++i) {
+                A[i * ld + j] *= scale;
+            }
+            if (tau[j] == 0) {
+                continue;
+            }
+            for (int c = j + 1; c < n; ++c) {
+                T w = R[j * ld + c];
+                for (int i = 0; i < m; ++i) {
+                    w += A[i * ld + j] * A[i * ld + c];
+                }
+                R[j * ld + c] -= tau[j] * w;
+                for (int i = 0; i < m; ++i) {
+                    A[i * ld + c] -= tau[j] * A[i * ld + j] * w;
+                }
+            }
+        }
+    }
+
+    // Applies the n reflectors tsqrt left in the m x n tile V to the tile pair (C1 over the
+    // m-row C2), both `cols` wide, in reverse when forming Q
+    static void tsmqr(T* C1, T* C2, const T* V, const T* tau, int ld, int m, int n, int cols, bool reverse) {
+        for (int step = 0; step < n; ++step) {
+            int j = reverse ? n - 1 - step : step;
+            if (tau[j] == 0) {
+                continue;
+            }
+            for (int c = 0; c < cols; ++c) {
+                T w = C1[j * ld + c];
+                for (int i = 0; i < m; ++i) {
+                    w += V[i * ld + j] * C2[i * ld + c];
+                }
+                C1[j * ld + c] -= tau[j] * w;
+                for (int i = 0; i < m; ++i) {
+                    C2[i * ld + c] -= tau[j] * V[i * ld + j] * w;
+                }
+            }
+        }
     }
 };
 
+// QR of a least-squares problem min |A x - b| that grows and shrinks one observation at a
+// time. Only the n x n triangle R, Q^T b and the residual norm are kept, never Q or the rows
+// seen so far, so memory stays O(n^2) however many rows have been appended. Appending a row
+// folds it into R with Givens rotations (LINPACK's dchud); removing a row downdates R
+// (dchdd). Both cost O(n^2) and sweep R row by row.
+template<typename T>
+class StreamingQR {
+public:
+    explicit StreamingQR(int columns) : n(columns), R(std::max(columns, 0), std::vector<T>(std::max(columns, 0), T(0))), z(std::max(columns, 0), T(0)) {
+        if (columns < 1) {
+            throw std::invalid_argument("A least-squares problem needs at least one column.");
+        }
+    }
+
+    // Adds the observation row . x = rhs
+    void appendRow(const std::vector<T>& row, T rhs) {
+        checkSize(row);
+        std::vector<T> x(row);
+        for (int i = 0; i < n; ++i) {
+            std::vector<T>& Ri = R[i];
+            if (x[i] == T(0)) {
+                continue;
+            }
+            T r = std::sqrt(Ri[i] * Ri[i] + x[i] * x[i]);
+            T c = Ri[i] / r;
+            T s = x[i] / r;
+            Ri[i] = r;
+            x[i] = T(0);
+            for (int j = i + 1; j < n; ++j) {
+                T t = c * Ri[j] + s * x[j];
+                x[j] = c * x[j] - s * Ri[j];
+                Ri[j] = t;
+            }
+            T t = c * z[i] + s * rhs;
+            rhs = c * rhs - s * z[i];
+            z[i] = t;
+        }
+        rho = std::sqrt(rho * rho + rhs * rhs);
+        ++count;
+    }
+
+    // Removes an observation added earlier. R must have full rank before and after; otherwise
+    // this throws and leaves the factorization unchanged.
+    void removeRow(const std::vector<T>& row, T rhs) {
+        checkSize(row);
+
+        // R^T a = row by forward substitution along the rows of R
+        std::vector<T> a(row);
+        T norm = 0;
+        for (int i = 0; i < n; ++i) {
+            if (std::abs(R[i][i]) < 1e-9) {
+                throw std::runtime_error("Cannot remove a row from a rank-deficient factorization.");
+            }
+            a[i] /= R[i][i];
+            norm += a[i] * a[i];
+            for (int j = i + 1; j < n; ++j) {
+                a[j] -= R[i][j] * a[i];
+            }
+        }
+        if (!(norm < T(1))) {
+            throw std::runtime_error("Removing the row would leave a rank-deficient factorization.");
+        }
+
+        std::vector<T> c(n), s(n);
+        T alpha = std::sqrt(T(1) - norm);
+        for (int i = n - 1; i >= 0; --i) {
+            T scale = alpha + std::abs(a[i]);
+            T p = alpha / scale;
+            T q = a[i] / scale;
+            T r = std::sqrt(p * p + q * q);
+            c[i] = p / r;
+            s[i] = q / r;
+            alpha = scale * r;
+        }
 
+        std::vector<T> carry(n, T(0));
+        for (int i = n - 1; i >= 0; --i) {
+            std::vector<T>& Ri = R[i];
+            for (int j = i; j < n; ++j) {
+                T t = c[i] * carry[j] + s[i] * Ri[j];
+                Ri[j] = c[i] * Ri[j] - s[i] * carry[j];
+                carry[j] = t;
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            z[i] = (z[i] - s[i] * rhs) / c[i];
+            rhs = c[i] * rhs - s[i] * z[i];
+        }
+        // rhs^2 <= rho^2 in exact arithmetic; clamp the rounding when the fit was exact
+        rho = std::sqrt(std::max(T(0), rho * rho - rhs * rhs));
+        --count;
+    }
 
+    // The least-squares solution for the rows currently held, by back substitution in R
+    std::vector<T> solve() const {
+        std::vector<T> x(n);
+        for (int i = n - 1; i >= 0; --i) {
+            if (std::abs(R[i][i]) < 1e-9) {
+                throw std::runtime_error("Least-squares problem is rank deficient.");
+            }
+            T sum = z[i];
+            for (int j = i + 1; j < n; ++j) {
+                sum -= R[i][j] * x[j];
+            }
+            x[i] = sum / R[i][i];
+        }
+        return x;
+    }
+
+    // |A x - b| at the solution
+    T residualNorm() const {
+        return rho;
+    }
+
+    const std::vector<std::vector<T>>& r() const {
+        return R;
+    }
+
+    int columns() const {
+        return n;
+    }
+
+    long long rows() const {
+        return count;
+    }
+
+private:
+    void checkSize(const std::vector<T>& row) const {
+        if (static_cast<int>(row.size()) != n) {
+            throw std::invalid_argument("Row length does not match the number of columns.");
+        }
+    }
+
+    int n;
+    std::vector<std::vector<T>> R;
+    std::vector<T> z;
+    T rho = 0;
+    long long count = 0;
+};
 
 #endif // QR_POLICIES_HPP
@@ -0,0 +1,676 @@
+#ifndef SVD_POLICIES_HPP
+#define SVD_POLICIES_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "Concepts.hpp"
+#include "Executor.hpp"
+#include "MatrixView.hpp"
+#include "MultiplicationPolicies.hpp"
+#include "QRPolicies.hpp"
+
+// Singular value decompositions A = U * diag(sigma) * V^T. Every policy returns U (rows x k),
+// the singular values in descending order and V (cols x k).
+
+// Building blocks shared by the SVD policies
+template<typename T>
+class SVDKernels {
+public:
+    // Below this many multiply-adds a Householder step is not worth handing to other threads
+    static constexpr double ParallelWork = 1 << 20;
+
+    // Economy QR of A (rows x cols, rows >= cols) by Householder reflections on the transposed
+    // matrix, so that every reflector works on contiguous memory: Q (rows x cols) with
+    // orthonormal columns, formed only if `formQ` (empty otherwise), and upper triangular R
+    // (cols x cols). The trailing columns are independent under each reflector, so tall
+    // matrices update them in parallel.
+    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> thinQR(const std::vector<std::vector<T>>& A, bool formQ = true) {
+        int rows = A.size();
+        int cols = rows > 0 ? A[0].size() : 0;
+        if (rows < cols) {
+            throw std::invalid_argument("An orthonormal basis needs at least as many rows as columns.");
+        }
+        std::vector<std::vector<T>> columns = transposed(A);
+        std::vector<T> tau(cols, T(0));
+        std::vector<std::vector<T>> R(cols, std::vector<T>(cols, T(0)));
+        MatrixExecutor& executor = MatrixExecutor::current();
+
+        for (int j = 0; j < cols; ++j) {
+            std::vector<T>& v = columns[j];
+            for (int i = 0; i < j; ++i) {
+                R[i][j] = v[i];
+            }
+            T norm = 0;
+            for (int i = j; i < rows; ++i) {
+                norm += v[i] * v[i];
+            }
+            norm = std::sqrt(norm);
+            if (norm == T(0)) {
+                continue;
+            }
+            // v = x - alpha e_j with alpha of opposite sign to x_j, scaled to v_j = 1
+            T alpha = v[j] > T(0) ? -norm : norm;
+            T head = v[j] - alpha;
+            for (int i = j + 1; i < rows; ++i) {
+                v[i] /= head;
+            }
+            v[j] = T(1);
+            tau[j] = -head / alpha;
+            R[j][j] = alpha;
+            forColumns(executor, j + 1, cols, rows - j, [&](int c) {
+                reflect(columns[c], v, tau[j], j, rows);
+            });
+        }
+        if (!formQ) {
+            return {{}, std::move(R)};
+        }
+
+        // Q e_c for c < cols, applying the reflectors in reverse
+        std::vector<std::vector<T>> basis(cols, std::vector<T>(rows, T(0)));
+        for (int c = 0; c < cols; ++c) {
+            basis[c][c] = T(1);
+        }
+        for (int j = cols - 1; j >= 0; --j) {
+            if (tau[j] == T(0)) {
+                continue;
+            }
+            forColumns(executor, j, cols, rows - j, [&](int c) {
+                reflect(basis[c], columns[j], tau[j], j, rows);
+            });
+        }
+        return {transposed(basis), std::move(R)};
+    }
+
+    // Orthonormal basis (rows x cols) of the columns of Y, rows >= cols
+    static std::vector<std::vector<T>> orthonormalBasis(const std::vector<std::vector<T>>& Y) {
+        return thinQR(Y).first;
+    }
+
+    // Makes vectors p and q of a one-sided Jacobi iteration orthogonal, applying the same
+    // rotation to gp and gq (which may be empty). Returns false when they already are, to
+    // working accuracy.
+    static bool rotate(std::vector<T>& p, std::vector<T>& q, std::vector<T>& gp, std::vector<T>& gq, T tolerance) {
+        int n = p.size();
+        T alpha = 0;
+        T beta = 0;
+        T gamma = 0;
+        for (int i = 0; i < n; ++i) {
+            alpha += p[i] * p[i];
+            beta += q[i] * q[i];
+            gamma += p[i] * q[i];
+        }
+        if (gamma == T(0) || std::abs(gamma) <= tolerance * std::sqrt(alpha * beta)) {
+            return false;
+        }
+        // tan of the angle that zeroes the off-diagonal of [alpha gamma; gamma beta], the smaller root
+        T zeta = (beta - alpha) / (2 * gamma);
+        T t = (zeta >= T(0) ? T(1) : T(-1)) / (std::abs(zeta) + std::sqrt(T(1) + zeta * zeta));
+        T c = T(1) / std::sqrt(T(1) + t * t);
+        T s = c * t;
+        for (int i = 0; i < n; ++i) {
+            T a = p[i];
+            T b = q[i];
+            p[i] = c * a - s * b;
+            q[i] = s * a + c * b;
+        }
+        for (int i = 0; i < static_cast<int>(gp.size()); ++i) {
+            T a = gp[i];
+            T b = gq[i];
+            gp[i] = c * a - s * b;
+            gq[i] = s * a + c * b;
+        }
+        return true;
+    }
+
+    static std::vector<std::vector<T>> transposed(const std::vector<std::vector<T>>& A) {
+        int rows = A.size();
+        int cols = rows > 0 ? A[0].size() : 0;
+        std::vector<std::vector<T>> result(cols, std::vector<T>(rows));
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                result[j][i] = A[i][j];
+            }
+        }
+        return result;
+    }
+
+private:
+    // x -= tau * (v . x) v over entries from..rows-1
+    static void reflect(std::vector<T>& x, const std::vector<T>& v, T tau, int from, int rows) {
+        T dot = 0;
+        for (int i = from; i < rows; ++i) {
+            dot += v[i] * x[i];
+        }
+        dot *= tau;
+        for (int i = from; i < rows; ++i) {
+            x[i] -= dot * v[i];
+        }
+    }
+
+    template<typename F>
+    static void forColumns(MatrixExecutor& executor, int first, int last, int length, F&& body) {
+        if (static_cast<double>(last - first) * length >= ParallelWork) {
+            executor.parallelFor(last - first, [&](int c) {
+                body(first + c);
+            });
+        } else {
+            for (int c = first; c < last; ++c) {
+                body(c);
+            }
+        }
+    }
+};
+
+// Full SVD by one-sided Jacobi (Hestenes): plane rotations of pairs of columns until all
+// columns are mutually orthogonal, which computes even tiny singular values to high relative
+// accuracy. Each sweep visits the pairs in round-robin tournament order, so the n / 2 pairs of
+// a round touch disjoint columns and large matrices rotate them in parallel. With
+// QRPreconditioning the iteration runs on R^T from the economy QR A = Q R instead (Drmac and
+// Veselic), which needs fewer sweeps; only the cols columns of Q that reach U are formed.
+// Returns min(rows, cols) singular triplets.
+template<typename T, bool QRPreconditioning = false>
+class OneSidedJacobiSVD {
+public:
+    // Below this many multiply-adds per round the pairs are not worth handing to other threads
+    static constexpr double ParallelWork = 1 << 18;
+    static constexpr int MaxSweeps = 60;
+
+    template<RowIndexable<T> Rows>
+    static std::tuple<std::vector<std::vector<T>>, std::vector<T>, std::vector<std::vector<T>>> calculate(const Rows& matrix) {
+        const auto& A = denseRows<T>(matrix);
+        int rows = A.size();
+        int cols = rows > 0 ? A[0].size() : 0;
+        if (rows < cols) {
+            // A^T = U' S V'^T gives A = V' S U'^T, and the columns of A^T are the rows of A
+            auto [U, sigma, V] = decompose(std::vector<std::vector<T>>(A), true);
+            return {std::move(V), std::move(sigma), std::move(U)};
+        }
+        if constexpr (QRPreconditioning) {
+            // A = Q1 R1 with R1 = X^T; X = U' S V'^T gives A = (Q1 V') S U'^T
+            auto [Q, R] = SVDKernels<T>::thinQR(A);
+            auto [U, sigma, V] = decompose(std::move(R), true);
+            return {BlockedMatrixMultiplication<T>::calculate(Q, V), std::move(sigma), std::move(U)};
+        } else {
+            return decompose(SVDKernels<T>::transposed(A), true);
+        }
+    }
+
+    // Singular values only, in descending order: no rotations are accumulated
+    template<RowIndexable<T> Rows>
+    static std::vector<T> singularValues(const Rows& matrix) {
+        const auto& A = denseRows<T>(matrix);
+        int rows = A.size();
+        int cols = rows > 0 ? A[0].size() : 0;
+        std::vector<std::vector<T>> columns;
+        if (rows < cols) {
+            columns = A;
+        } else if constexpr (QRPreconditioning) {
+            columns = std::move(SVDKernels<T>::thinQR(A, false).second);
+        } else {
+            columns = SVDKernels<T>::transposed(A);
+        }
+        return std::get<1>(decompose(std::move(columns), false));
+    }
+
+    // Moore-Penrose pseudoinverse V * S^+ * U^T (cols x rows). Singular values at or below
+    // `tolerance` count as zero; a negative tolerance means max(rows, cols) * eps * sigma_max.
+    template<RowIndexable<T> Rows>
+    static std::vector<std::vector<T>> pseudoInverse(const Rows& matrix, T tolerance = T(-1)) {
+        auto [U, sigma, V] = calculate(matrix);
+        T cutoff = threshold(matrix, sigma, tolerance);
+        for (auto& row : V) {
+            for (int c = 0; c < static_cast<int>(sigma.size()); ++c) {
+                row[c] = sigma[c] > cutoff ? row[c] / sigma[c] : T(0);
+            }
+        }
+        return TransposedMultiplication<T>::nt(V, U);
+    }
+
+    // Number of singular values above `tolerance`, with the same default as pseudoInverse
+    template<RowIndexable<T> Rows>
+    static int rank(const Rows& matrix, T tolerance = T(-1)) {
+        std::vector<T> sigma = singularValues(matrix);
+        T cutoff = threshold(matrix, sigma, tolerance);
+        return static_cast<int>(std::count_if(sigma.begin(), sigma.end(), [&](T value) {
+            return value > cutoff;
+        }));
+    }
+
+    // SVD of the rows x k matrix whose columns are columns[0..k-1], k <= rows: returns U (rows x k),
+    // the singular values and, if `vectors`, V (k x k); otherwise U and V are empty
+    static std::tuple<std::vector<std::vector<T>>, std::vector<T>, std::vector<std::vector<T>>> decompose(std::vector<std::vector<T>> columns, bool vectors) {
+        int k = columns.size();
+        int rows = k > 0 ? columns[0].size() : 0;
+        std::vector<std::vector<T>> Vt;
+        if (vectors) {
+            Vt.assign(k, std::vector<T>(k, T(0)));
+            for (int i = 0; i < k; ++i) {
+                Vt[i][i] = T(1);
+            }
+        }
+        orthogonalize(columns, Vt);
+
+        std::vector<T> norms(k);
+        for (int j = 0; j < k; ++j) {
+            T sum = 0;
+            for (T value : columns[j]) {
+                sum += value * value;
+            }
+            norms[j] = std::sqrt(sum);
+        }
+        std::vector<int> order(k);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return norms[a] > norms[b];
+        });
+
+        std::vector<T> sigma(k);
+        for (int c = 0; c < k; ++c) {
+            sigma[c] = norms[order[c]];
+        }
+        if (!vectors) {
+            return {std::vector<std::vector<T>>(), std::move(sigma), std::vector<std::vector<T>>()};
+        }
+
+        // A V = U S: column j of the rotated matrix is sigma_j u_j and row j of Vt is v_j
+        std::vector<std::vector<T>> U(rows, std::vector<T>(k, T(0)));
+        std::vector<std::vector<T>> V(k, std::vector<T>(k));
+        for (int c = 0; c < k; ++c) {
+            int j = order[c];
+            if (norms[j] > T(0)) {
+                for (int i = 0; i < rows; ++i) {
+                    U[i][c] = columns[j][i] / norms[j];
+                }
+            }
+            for (int i = 0; i < k; ++i) {
+                V[i][c] = Vt[j][i];
+            }
+        }
+        completeBasis(U, sigma);
+        return {std::move(U), std::move(sigma), std::move(V)};
+    }
+
+private:
+    // Sweeps of round-robin rounds until a whole sweep rotates nothing. Round r pairs the
+    // players at positions i and m - 1 - i, then every player but the first moves one place,
+    // so each pair meets once per sweep; an odd count adds a bye.
+    static void orthogonalize(std::vector<std::vector<T>>& columns, std::vector<std::vector<T>>& Vt) {
+        int k = columns.size();
+        if (k < 2) {
+            return;
+        }
+        int rows = columns[0].size();
+        T tolerance = std::numeric_limits<T>::epsilon() * std::sqrt(static_cast<T>(rows));
+        int players = k + (k % 2);
+        std::vector<int> position(players);
+        std::iota(position.begin(), position.end(), 0);
+        std::vector<T> none;
+
+        MatrixExecutor& executor = MatrixExecutor::current();
+        bool parallel = static_cast<double>(rows + Vt.size()) * 3 * (players / 2) >= ParallelWork && !executor.inWorker();
+        std::atomic<bool> rotated{false};
+        auto rotatePair = [&](int i) {
+            int p = position[i];
+            int q = position[players - 1 - i];
+            if (p >= k || q >= k) {
+                return;
+            }
+            if (p > q) {
+                std::swap(p, q);
+            }
+            bool changed = Vt.empty() ? SVDKernels<T>::rotate(columns[p], columns[q], none, none, tolerance)
+                                      : SVDKernels<T>::rotate(columns[p], columns[q], Vt[p], Vt[q], tolerance);
+            if (changed) {
+                rotated.store(true, std::memory_order_relaxed);
+            }
+        };
+
+        for (int sweep = 0; sweep < MaxSweeps; ++sweep) {
+            rotated.store(false, std::memory_order_relaxed);
+            for (int round = 0; round < players - 1; ++round) {
+                if (parallel) {
+                    executor.parallelFor(players / 2, rotatePair);
+                } else {
+                    for (int i = 0; i < players / 2; ++i) {
+                        rotatePair(i);
+                    }
+                }
+                std::rotate(position.begin() + 1, position.end() - 1, position.end());
+            }
+            if (!rotated.load(std::memory_order_relaxed)) {
+                break;
+            }
+        }
+    }
+
+    // Columns of U for zero singular values are left zero by the rotations; fill them with unit
+    // vectors orthogonalized (twice) against the others so that U stays orthonormal
+    static void completeBasis(std::vector<std::vector<T>>& U, const std::vector<T>& sigma) {
+        int rows = U.size();
+        int k = sigma.size();
+        int candidate = 0;
+        for (int c = 0; c < k; ++c) {
+            if (sigma[c] > T(0)) {
+                continue;
+            }
+            while (candidate < rows) {
+                std::vector<T> v(rows, T(0));
+                v[candidate++] = T(1);
+                for (int pass = 0; pass < 2; ++pass) {
+                    for (int other = 0; other < k; ++other) {
+                        if (other == c) {
+                            continue;
+                        }
+                        T dot = 0;
+                        for (int i = 0; i < rows; ++i) {
+                            dot += U[i][other] * v[i];
+                        }
+                        for (int i = 0; i < rows; ++i) {
+                            v[i] -= dot * U[i][other];
+                        }
+                    }
+                }
+                T norm = 0;
+                for (T value : v) {
+                    norm += value * value;
+                }
+                norm = std::sqrt(norm);
+                if (norm > T(0.5)) {
+                    for (int i = 0; i < rows; ++i) {
+                        U[i][c] = v[i] / norm;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    template<typename Rows>
+    static T threshold(const Rows& matrix, const std::vector<T>& sigma, T tolerance) {
+        if (tolerance >= T(0)) {
+            return tolerance;
+        }
+        int rows = matrix.size();
+        int cols = rows > 0 ? matrix[0].size() : 0;
+        T largest = sigma.empty() ? T(0) : sigma[0];
+        return static_cast<T>(std::max(rows, cols)) * std::numeric_limits<T>::epsilon() * largest;
+    }
+};
+
+// Truncated SVD of rank k by randomized range finding (Halko, Martinsson and Tropp): sketch
+// Y = A * Omega with k + oversampling random columns, optionally sharpen it with power
+// iterations, take an orthonormal basis Q of Y, and compute the SVD of the small
+// B = Q^T * A exactly. The products run on the blocked GEMMs, O(mnk) in total, and A is read
+// 2 + 2 * powerIterations times. SinglePass sketches rows as they arrive and reads them once.
+template<typename T>
+class RandomizedSVD {
+public:
+    enum class Sketch {
+        // Dense standard normal test matrix
+        Gaussian,
+        // SparseNonzeros random signs per row of Omega, so A * Omega costs O(mn) multiply-adds
+        SparseSign
+    };
+
+    static constexpr int SparseNonzeros = 8;
+    static constexpr std::uint64_t DefaultSeed = 42;
+
+    template<RowIndexable<T> Rows>
+    static std::tuple<std::vector<std::vector<T>>, std::vector<T>, std::vector<std::vector<T>>> calculate(const Rows& matrix, int rank, int powerIterations = 1, int oversampling = 10, Sketch sketch = Sketch::Gaussian, std::uint64_t seed = DefaultSeed) {
+        const auto& A = denseRows<T>(matrix);
+        int rows = A.size();
+        int cols = rows > 0 ? A[0].size() : 0;
+        int width = sketchWidth(rows, cols, rank, oversampling);
+
+        std::mt19937_64 rng(seed);
+        std::vector<std::vector<T>> Q = SVDKernels<T>::orthonormalBasis(multiplySketch(A, testMatrix(cols, width, sketch, rng), sketch));
+        for (int iteration = 0; iteration < powerIterations; ++iteration) {
+            // Orthonormalizing between the products keeps the small singular values from
+            // drowning in rounding as (A A^T)^q amplifies the large ones
+            Q = SVDKernels<T>::orthonormalBasis(TransposedMultiplication<T>::tn(A, Q));
+            Q = SVDKernels<T>::orthonormalBasis(BlockedMatrixMultiplication<T>::calculate(A, Q));
+        }
+        return finish(Q, TransposedMultiplication<T>::tn(Q, A), rank);
+    }
+
+    // The rank-k approximation U * diag(sigma) * V^T as a dense matrix
+    template<RowIndexable<T> Rows>
+    static std::vector<std::vector<T>> approximate(const Rows& matrix, int rank, int powerIterations = 1) {
+        auto [U, sigma, V] = calculate(matrix, rank, powerIterations);
+        for (auto& row : U) {
+            for (int c = 0; c < static_cast<int>(sigma.size()); ++c) {
+                row[c] *= sigma[c];
+            }
+        }
+        return TransposedMultiplication<T>::nt(U, V);
+    }
+
+    // Single-pass variant for rows that arrive one at a time (Tropp, Yurtsever, Udell and
+    // Cevher): each row adds to the range sketch Y = A * Omega and to the co-range sketch
+    // W = Psi * A, and A is recovered as Q * X with X the least-squares solution of
+    // (Psi * Q) X = W. Less accurate than calculate() with power iterations, but no row is kept.
+    // Row i of Psi^T is drawn from its own random stream seeded by (seed, i), so it is
+    // regenerated when needed instead of stored, and memory grows only with Y.
+    class SinglePass {
+    public:
+        SinglePass(int columns, int rank, int oversampling = 10, Sketch sketch = Sketch::Gaussian, std::uint64_t seed = DefaultSeed)
+            : cols(columns), targetRank(rank), seed(seed), kind(sketch) {
+            if (columns < 1 || rank < 1) {
+                throw std::invalid_argument("Rank and column count must be positive.");
+            }
+            width = std::min(rank + std::max(oversampling, 0), columns);
+            coWidth = 2 * width + 1;
+            std::mt19937_64 rng(seed);
+            omega = testMatrix(columns, width, sketch, rng);
+            if (sketch == Sketch::Gaussian) {
+                nonzeros.assign(columns, std::vector<int>(width));
+                for (auto& row : nonzeros) {
+                    std::iota(row.begin(), row.end(), 0);
+                }
+            } else {
+                nonzeros = nonzeroColumns(omega);
+            }
+            W.assign(coWidth, std::vector<T>(columns, T(0)));
+        }
+
+        void addRow(const std::vector<T>& row) {
+            if (static_cast<int>(row.size()) != cols) {
+                throw std::invalid_argument("Row length does not match the number of columns.");
+            }
+            Y.emplace_back(width, T(0));
+            sketchRow(row, omega, nonzeros, Y.back());
+            std::vector<T> weights = psiRow(rows() - 1);
+            for (int r = 0; r < coWidth; ++r) {
+                if (weights[r] == T(0)) {
+                    continue;
+                }
+                T* target = W[r].data();
+                for (int j = 0; j < cols; ++j) {
+                    target[j] += weights[r] * row[j];
+                }
+            }
+        }
+
+        int rows() const {
+            return Y.size();
+        }
+
+        std::tuple<std::vector<std::vector<T>>, std::vector<T>, std::vector<std::vector<T>>> result() const {
+            if (static_cast<int>(Y.size()) < width) {
+                throw std::runtime_error("Not enough rows for the requested rank.");
+            }
+            std::vector<std::vector<T>> Q = SVDKernels<T>::orthonormalBasis(Y);
+            // Psi * Q, accumulated over the regenerated rows of Psi^T
+            std::vector<std::vector<T>> psiQ(coWidth, std::vector<T>(width, T(0)));
+            for (int i = 0; i < rows(); ++i) {
+                std::vector<T> weights = psiRow(i);
+                for (int s = 0; s < coWidth; ++s) {
+                    if (weights[s] == T(0)) {
+                        continue;
+                    }
+                    for (int c = 0; c < width; ++c) {
+                        psiQ[s][c] += weights[s] * Q[i][c];
+                    }
+                }
+            }
+            auto [q, r] = Householder<T>::calculate(psiQ);
+            std::vector<std::vector<T>> X = TransposedMultiplication<T>::tn(q, W);
+            X.resize(width);
+            for (int i = width - 1; i >= 0; --i) {
+                if (std::abs(r[i][i]) < std::numeric_limits<T>::epsilon() * std::abs(r[0][0])) {
+                    throw std::runtime_error("Sketch of the rows is rank deficient.");
+                }
+                for (int k = i + 1; k < width; ++k) {
+                    for (int j = 0; j < cols; ++j) {
+                        X[i][j] -= r[i][k] * X[k][j];
+                    }
+                }
+                for (int j = 0; j < cols; ++j) {
+                    X[i][j] /= r[i][i];
+                }
+            }
+            return finish(Q, X, targetRank);
+        }
+
+    private:
+        // Row i of Psi^T
+        std::vector<T> psiRow(int i) const {
+            std::mt19937_64 stream(streamSeed(seed, i));
+            return testRow(coWidth, kind, stream);
+        }
+
+        int cols;
+        int targetRank;
+        int width;
+        int coWidth;
+        std::uint64_t seed;
+        Sketch kind;
+        std::vector<std::vector<T>> omega;
+        std::vector<std::vector<int>> nonzeros;
+        std::vector<std::vector<T>> Y;
+        std::vector<std::vector<T>> W;
+    };
+
+private:
+    static int sketchWidth(int rows, int cols, int rank, int oversampling) {
+        if (rank < 1 || rank > std::min(rows, cols)) {
+            throw std::invalid_argument("Rank must be between 1 and the smaller matrix dimension.");
+        }
+        return std::min(rank + std::max(oversampling, 0), std::min(rows, cols));
+    }
+
+    // Seed of the independent random stream `index` derived from `seed` (SplitMix64's mixing)
+    static std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t index) {
+        std::uint64_t z = seed + (index + 1) * 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // One row of a test matrix with `width` columns
+    static std::vector<T> testRow(int width, Sketch sketch, std::mt19937_64& rng) {
+        std::vector<T> row(width, T(0));
+        if (sketch == Sketch::Gaussian) {
+            std::normal_distribution<double> normal;
+            for (T& value : row) {
+                value = static_cast<T>(normal(rng));
+            }
+        } else {
+            int nonzeros = std::min(SparseNonzeros, width);
+            T scale = T(1) / std::sqrt(static_cast<T>(nonzeros));
+            std::uniform_int_distribution<int> column(0, width - 1);
+            for (int placed = 0; placed < nonzeros;) {
+                int c = column(rng);
+                if (row[c] == T(0)) {
+                    row[c] = (rng() & 1) ? scale : -scale;
+                    ++placed;
+                }
+            }
+        }
+        return row;
+    }
+
+    static std::vector<std::vector<T>> testMatrix(int rows, int width, Sketch sketch, std::mt19937_64& rng) {
+        std::vector<std::vector<T>> omega(rows);
+        for (auto& row : omega) {
+            row = testRow(width, sketch, rng);
+        }
+        return omega;
+    }
+
+    // Column indices of the nonzeros in each row of a SparseSign test matrix
+    static std::vector<std::vector<int>> nonzeroColumns(const std::vector<std::vector<T>>& omega) {
+        std::vector<std::vector<int>> nonzeros(omega.size());
+        for (std::size_t j = 0; j < omega.size(); ++j) {
+            for (int c = 0; c < static_cast<int>(omega[j].size()); ++c) {
+                if (omega[j][c] != T(0)) {
+                    nonzeros[j].push_back(c);
+                }
+            }
+        }
+        return nonzeros;
+    }
+
+    // row * Omega, visiting only the nonzeros of a sparse sketch
+    static void sketchRow(const std::vector<T>& row, const std::vector<std::vector<T>>& omega, const std::vector<std::vector<int>>& nonzeros, std::vector<T>& result) {
+        for (int j = 0; j < static_cast<int>(row.size()); ++j) {
+            T a = row[j];
+            const std::vector<T>& weights = omega[j];
+            for (int c : nonzeros[j]) {
+                result[c] += a * weights[c];
+            }
+        }
+    }
+
+    static std::vector<std::vector<T>> multiplySketch(const std::vector<std::vector<T>>& A, const std::vector<std::vector<T>>& omega, Sketch sketch) {
+        if (sketch == Sketch::Gaussian) {
+            return BlockedMatrixMultiplication<T>::calculate(A, omega);
+        }
+        int rows = A.size();
+        int width = omega[0].size();
+        std::vector<std::vector<int>> nonzeros = nonzeroColumns(omega);
+        std::vector<std::vector<T>> Y(rows, std::vector<T>(width, T(0)));
+        auto sketchRows = [&](int first, int last) {
+            for (int i = first; i < last; ++i) {
+                sketchRow(A[i], omega, nonzeros, Y[i]);
+            }
+        };
+        MatrixExecutor& executor = MatrixExecutor::current();
+        double work = static_cast<double>(rows) * A[0].size() * SparseNonzeros;
+        if (work >= BlockedMatrixMultiplication<T>::ParallelWork && !executor.inWorker()) {
+            int bands = executor.threadCount();
+            executor.parallelFor(bands, [&](int band) {
+                sketchRows(static_cast<long long>(rows) * band / bands, static_cast<long long>(rows) * (band + 1) / bands);
+            });
+        } else {
+            sketchRows(0, rows);
+        }
+        return Y;
+    }
+
+    // SVD of B = Q^T A, lifted back through Q and truncated to `rank`
+    static std::tuple<std::vector<std::vector<T>>, std::vector<T>, std::vector<std::vector<T>>> finish(const std::vector<std::vector<T>>& Q, std::vector<std::vector<T>> B, int rank) {
+        // The rows of B are the columns of B^T = V S smallU^T
+        auto [V, sigma, smallU] = OneSidedJacobiSVD<T>::decompose(std::move(B), true);
+        std::vector<std::vector<T>> U = BlockedMatrixMultiplication<T>::calculate(Q, smallU);
+        for (auto& row : U) {
+            row.resize(rank);
+        }
+        sigma.resize(rank);
+        for (auto& row : V) {
+            row.resize(rank);
+        }
+        return {std::move(U), std::move(sigma), std::move(V)};
+    }
+};
+
+#endif // SVD_POLICIES_HPP
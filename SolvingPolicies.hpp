@@ -4,15 +4,26 @@
 #include <vector>
 #include <stdexcept>
 #include <cmath>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "BandedMatrix.hpp"
+#include "Concepts.hpp"
+#include "ExactArithmetic.hpp"
+#include "Executor.hpp"
+#include "MatrixView.hpp"
+#include "Workspace.hpp"
 
 
 template<typename T>
 class GaussianEliminationSolver {
 public:
-    static std::vector<T> solve(const std::vector<std::vector<T>>& A, const std::vector<T>& b) {
+    template<RowIndexable<T> Rows>
+    static std::vector<T> solve(const Rows& A, const std::vector<T>& b) {
         int n = A.size();
         
-        std::vector<std::vector<T>> matrix = A;
+        std::vector<std::vector<T>> matrix = copyMatrix(A);
         std::vector<T> vec = b;
 
         for (int i = 0; i < n; ++i) {
@@ -48,12 +59,202 @@ public:
 
         return x;
     }
+
+private:
+    template<typename Rows>
+    static std::vector<std::vector<T>> copyMatrix(const Rows& A) {
+        if constexpr (std::is_same_v<Rows, std::vector<std::vector<T>>>) {
+            return A;
+        } else {
+            int n = A.size();
+            std::vector<std::vector<T>> matrix(n, std::vector<T>(n));
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    matrix[i][j] = A[i][j];
+                }
+            }
+            return matrix;
+        }
+    }
 };
 
+// Factorizes in Lower (float by default) and recovers T accuracy with iterative
+// refinement: residuals are computed in T against the original matrix and the
+// corrections are solved with the low-precision factors. If refinement stops
+// converging (the system is too ill-conditioned for Lower), the matrix is
+// refactorized in T.
+template<typename T, typename Lower = float>
+class MixedPrecisionSolver {
+public:
+    template<RowIndexable<T> Rows>
+    static std::vector<T> solve(const Rows& A, const std::vector<T>& b, int maxIterations = 30) {
+        int n = A.size();
+        WorkspaceScope workspace;
+
+        std::vector<T> x(n, 0);
+        WorkspaceVector<T> residual = makeWorkspaceVector<T>(n);
+        WorkspaceVector<T> correction = makeWorkspaceVector<T>(n);
+        WorkspaceVector<int> pivots = makeWorkspaceVector<int>(n);
+
+        WorkspaceVector<Lower> lowFactors = makeWorkspaceVector<Lower>(n * n);
+        if (factorize(A, lowFactors, pivots)) {
+            T normA = infinityNorm(A);
+            T normB = 0;
+            for (int i = 0; i < n; ++i) {
+                normB = std::max(normB, static_cast<T>(std::abs(b[i])));
+            }
+            T tolerance = static_cast<T>(n) * std::numeric_limits<T>::epsilon();
+            T previousCorrection = std::numeric_limits<T>::max();
+
+            for (int iteration = 0; iteration < maxIterations; ++iteration) {
+                T residualNorm = computeResidual(A, b, x, residual);
+                T normX = 0;
+                for (int i = 0; i < n; ++i) {
+                    normX = std::max(normX, static_cast<T>(std::abs(x[i])));
+                }
+                if (iteration > 0 && residualNorm <= tolerance * (normA * normX + normB)) {
+                    return x;
+                }
+
+                substitute(lowFactors, pivots, residual, correction);
+                T correctionNorm = 0;
+                for (int i = 0; i < n; ++i) {
+                    x[i] += correction[i];
+                    correctionNorm = std::max(correctionNorm, static_cast<T>(std::abs(correction[i])));
+                }
+                if (!std::isfinite(correctionNorm)) {
+                    break;
+                }
+                if (correctionNorm <= std::numeric_limits<T>::epsilon() * normX) {
+                    return x;
+                }
+                if (iteration > 0 && correctionNorm > previousCorrection / 2) {
+                    break;
+                }
+                previousCorrection = correctionNorm;
+            }
+        }
+
+        // Refinement stalled or the low-precision factorization broke down
+        WorkspaceVector<T> factors = makeWorkspaceVector<T>(n * n);
+        if (!factorize(A, factors, pivots)) {
+            throw std::runtime_error("Singular matrix encountered during mixed-precision solve.");
+        }
+        for (int i = 0; i < n; ++i) {
+            residual[i] = b[i];
+        }
+        substitute(factors, pivots, residual, correction);
+        for (int i = 0; i < n; ++i) {
+            x[i] = correction[i];
+        }
+        return x;
+    }
+
+private:
+    // In-place LU with partial pivoting on a row-major copy of A in precision P
+    template<typename P, typename Rows>
+    static bool factorize(const Rows& A, WorkspaceVector<P>& lu, WorkspaceVector<int>& pivots) {
+        int n = A.size();
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                lu[i * n + j] = static_cast<P>(A[i][j]);
+            }
+        }
+
+        for (int k = 0; k < n; ++k) {
+            int pivot = k;
+            for (int i = k + 1; i < n; ++i) {
+                if (std::abs(lu[i * n + k]) > std::abs(lu[pivot * n + k])) {
+                    pivot = i;
+                }
+            }
+            pivots[k] = pivot;
+            if (lu[pivot * n + k] == 0 || !std::isfinite(lu[pivot * n + k])) {
+                return false;
+            }
+            if (pivot != k) {
+                std::swap_ranges(lu.begin() + k * n, lu.begin() + (k + 1) * n, lu.begin() + pivot * n);
+            }
+
+            P* rowK = lu.data() + k * n;
+            for (int i = k + 1; i < n; ++i) {
+                P* rowI = lu.data() + i * n;
+                P factor = rowI[k] / rowK[k];
+                rowI[k] = factor;
+                for (int j = k + 1; j < n; ++j) {
+                    rowI[j] -= factor * rowK[j];
+                }
+            }
+        }
+        return true;
+    }
+
+    // Solves LU * out = P * rhs, rounding rhs to the precision of the factors
+    template<typename P>
+    static void substitute(const WorkspaceVector<P>& lu, const WorkspaceVector<int>& pivots, const WorkspaceVector<T>& rhs, WorkspaceVector<T>& out) {
+        int n = pivots.size();
+        WorkspaceVector<P> y = makeWorkspaceVector<P>(n);
+        for (int i = 0; i < n; ++i) {
+            y[i] = static_cast<P>(rhs[i]);
+        }
+        for (int k = 0; k < n; ++k) {
+            std::swap(y[k], y[pivots[k]]);
+        }
+
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < i; ++j) {
+                y[i] -= lu[i * n + j] * y[j];
+            }
+        }
+        for (int i = n - 1; i >= 0; --i) {
+            for (int j = i + 1; j < n; ++j) {
+                y[i] -= lu[i * n + j] * y[j];
+            }
+            y[i] /= lu[i * n + i];
+        }
+
+        for (int i = 0; i < n; ++i) {
+            out[i] = static_cast<T>(y[i]);
+        }
+    }
+
+    // r = b - A * x in T; returns the infinity norm of r
+    template<typename Rows>
+    static T computeResidual(const Rows& A, const std::vector<T>& b, const std::vector<T>& x, WorkspaceVector<T>& r) {
+        int n = A.size();
+        T norm = 0;
+        for (int i = 0; i < n; ++i) {
+            T sum = b[i];
+            for (int j = 0; j < n; ++j) {
+                sum -= A[i][j] * x[j];
+            }
+            r[i] = sum;
+            norm = std::max(norm, static_cast<T>(std::abs(sum)));
+        }
+        return norm;
+    }
+
+    template<typename Rows>
+    static T infinityNorm(const Rows& A) {
+        int n = A.size();
+        T norm = 0;
+        for (int i = 0; i < n; ++i) {
+            T sum = 0;
+            for (int j = 0; j < n; ++j) {
+                sum += std::abs(A[i][j]);
+            }
+            norm = std::max(norm, sum);
+        }
+        return norm;
+    }
+};
+
+
 template<typename T>
 class LUDecomposition {
 public:
-    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> decompose(const std::vector<std::vector<T>>& A) {
+    template<RowIndexable<T> Rows>
+    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> decompose(const Rows& A) {
         int n = A.size();
         std::vector<std::vector<T>> L(n, std::vector<T>(n, 0));
         std::vector<std::vector<T>> U(n, std::vector<T>(n, 0));
@@ -82,7 +283,8 @@ public:
         return {L, U};
     }
 
-    static std::vector<T> solve(const std::vector<std::vector<T>>& A, const std::vector<T>& b) {
+    template<RowIndexable<T> Rows>
+    static std::vector<T> solve(const Rows& A, const std::vector<T>& b) {
         auto [L, U] = decompose(A);
         int n = L.size();
 
@@ -113,7 +315,8 @@ public:
 template<typename T>
 class CholeskySolver {
 public:
-    static std::vector<std::vector<T>> decompose(const std::vector<std::vector<T>>& A) {
+    template<RowIndexable<T> Rows>
+    static std::vector<std::vector<T>> decompose(const Rows& A) {
         int n = A.size();
         std::vector<std::vector<T>> L(n, std::vector<T>(n, 0));
 
@@ -135,8 +338,8 @@ public:
         return L;
     }
 
-    static std::vector<T> solve(const std::vector<std::vector<T>>& A, const std::vector<T>& b) {
-        std::cout << "Cholesky" << std::endl;
+    template<RowIndexable<T> Rows>
+    static std::vector<T> solve(const Rows& A, const std::vector<T>& b) {
         auto L = decompose(A);
         int n = L.size();
 
@@ -166,11 +369,12 @@ public:
 template<typename T>
 class QRSolver {
 public:
-    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> decompose(const std::vector<std::vector<T>>& A) {
+    template<RowIndexable<T> Rows>
+    static std::pair<std::vector<std::vector<T>>, std::vector<std::vector<T>>> decompose(const Rows& A) {
         int n = A.size();
         std::vector<std::vector<T>> Q(n, std::vector<T>(n, 0));
         std::vector<std::vector<T>> R(n, std::vector<T>(n, 0));
-        std::vector<std::vector<T>> A_copy = A;
+        std::vector<std::vector<T>> A_copy = denseRows<T>(A);
 
         for (int k = 0; k < n; k++) {
             for (int i = 0; i < n; i++) {
@@ -193,7 +397,8 @@ public:
         return {Q, R};
     }
 
-    static std::vector<T> solve(const std::vector<std::vector<T>>& A, const std::vector<T>& b) {
+    template<RowIndexable<T> Rows>
+    static std::vector<T> solve(const Rows& A, const std::vector<T>& b) {
         auto [Q, R] = decompose(A);
         int n = Q.size();
 
@@ -225,13 +430,23 @@ public:
 template<typename T>
 class JacobiSolver {
 public:
-    static std::vector<T> solve(const std::vector<std::vector<T>>& A, const std::vector<T>& b, T tolerance = 1e-7, int maxIterations = 1000) {
+    // Below this many matrix elements a sweep is not worth handing to other threads
+    static constexpr double ParallelWork = 1 << 18;
+
+    template<RowIndexable<T> Rows>
+    static std::vector<T> solve(const Rows& A, const std::vector<T>& b, T tolerance = 1e-7, int maxIterations = 1000) {
         int n = A.size();
         std::vector<T> x(n, 0);
         std::vector<T> x_old(n, 0);
 
-        for (int iteration = 0; iteration < maxIterations; ++iteration) {
-            for (int i = 0; i < n; ++i) {
+        // Every row of a sweep reads only x_old, so large systems split the sweep into row bands
+        MatrixExecutor& executor = MatrixExecutor::current();
+        int bands = 1;
+        if (static_cast<double>(n) * n >= ParallelWork && !executor.inWorker()) {
+            bands = executor.threadCount();
+        }
+        auto sweep = [&](int first, int last) {
+            for (int i = first; i < last; ++i) {
                 T sigma = 0;
                 for (int j = 0; j < n; ++j) {
                     if (i != j) {
@@ -240,6 +455,16 @@ public:
                 }
                 x[i] = (b[i] - sigma) / A[i][i];
             }
+        };
+
+        for (int iteration = 0; iteration < maxIterations; ++iteration) {
+            if (bands > 1) {
+                executor.parallelFor(bands, [&](int band) {
+                    sweep(static_cast<long long>(n) * band / bands, static_cast<long long>(n) * (band + 1) / bands);
+                });
+            } else {
+                sweep(0, n);
+            }
             T error = 0;
             for (int i = 0; i < n; ++i) {
                 error += std::abs(x[i] - x_old[i]);
@@ -259,7 +484,8 @@ public:
 template<typename T>
 class GaussSeidelSolver {
 public:
-    static std::vector<T> solve(const std::vector<std::vector<T>>& A, const std::vector<T>& b, T tolerance = 1e-7, int maxIterations = 1000) {
+    template<RowIndexable<T> Rows>
+    static std::vector<T> solve(const Rows& A, const std::vector<T>& b, T tolerance = 1e-7, int maxIterations = 1000) {
         int n = A.size();
         std::vector<T> x(n, 0);
         std::vector<T> x_old(n, 0);
@@ -290,8 +516,331 @@ public:
 };
 
 
+// Inspects A in one O(n^2) pass and solves with the cheapest method its structure allows:
+// substitution for diagonal and triangular matrices, the band solvers when every nonzero lies
+// in a narrow band, Cholesky when A is symmetric with a positive diagonal, and pivoted
+// elimination otherwise or when Cholesky finds A is not positive definite. The path taken by
+// the last solve on the calling thread is kept for diagnostics.
+template<typename T>
+class AutoSolver {
+public:
+    enum class Path {
+        Diagonal,
+        LowerTriangular,
+        UpperTriangular,
+        Tridiagonal,
+        BandedCholesky,
+        BandedLU,
+        Cholesky,
+        PivotedLU
+    };
+
+    struct Structure {
+        int lowerBandwidth = 0;
+        int upperBandwidth = 0;
+        bool symmetric = true;
+        bool diagonallyDominant = true;
+        bool positiveDiagonal = true;
+    };
+
+    // Band solvers pay for copying into band storage and for their index arithmetic, so the
+    // band has to be narrower than n / BandDivisor before they win over dense elimination
+    static constexpr int BandDivisor = 4;
+
+    template<RowIndexable<T> Rows>
+    static Structure inspect(const Rows& A) {
+        int n = A.size();
+        Structure s;
+        for (int i = 0; i < n; ++i) {
+            T offDiagonal = 0;
+            for (int j = 0; j < n; ++j) {
+                const T& value = A[i][j];
+                if (j == i || value == T(0)) {
+                    continue;
+                }
+                offDiagonal += std::abs(value);
+                if (j < i) {
+                    s.lowerBandwidth = std::max(s.lowerBandwidth, i - j);
+                } else {
+                    s.upperBandwidth = std::max(s.upperBandwidth, j - i);
+                }
+                if (s.symmetric && !(A[j][i] == value)) {
+                    s.symmetric = false;
+                }
+            }
+            if (!(std::abs(A[i][i]) > offDiagonal)) {
+                s.diagonallyDominant = false;
+            }
+            if (!(A[i][i] > T(0))) {
+                s.positiveDiagonal = false;
+            }
+        }
+        return s;
+    }
+
+    template<RowIndexable<T> Rows>
+    static std::vector<T> solve(const Rows& A, const std::vector<T>& b) {
+        int n = A.size();
+        Structure s = inspect(A);
+
+        if (s.lowerBandwidth == 0 && s.upperBandwidth == 0) {
+            record(Path::Diagonal);
+            std::vector<T> x(n);
+            for (int i = 0; i < n; ++i) {
+                x[i] = b[i] / pivot(A[i][i]);
+            }
+            return x;
+        }
+        if (s.upperBandwidth == 0) {
+            record(Path::LowerTriangular);
+            std::vector<T> x(n);
+            for (int i = 0; i < n; ++i) {
+                T sum = b[i];
+                for (int j = std::max(0, i - s.lowerBandwidth); j < i; ++j) {
+                    sum -= A[i][j] * x[j];
+                }
+                x[i] = sum / pivot(A[i][i]);
+            }
+            return x;
+        }
+        if (s.lowerBandwidth == 0) {
+            record(Path::UpperTriangular);
+            std::vector<T> x(n);
+            for (int i = n - 1; i >= 0; --i) {
+                T sum = b[i];
+                for (int j = i + 1; j <= std::min(n - 1, i + s.upperBandwidth); ++j) {
+                    sum -= A[i][j] * x[j];
+                }
+                x[i] = sum / pivot(A[i][i]);
+            }
+            return x;
+        }
+
+        if (s.lowerBandwidth + s.upperBandwidth + 1 <= n / BandDivisor) {
+            if (s.lowerBandwidth == 1 && s.upperBandwidth == 1 && s.diagonallyDominant) {
+                record(Path::Tridiagonal);
+                TridiagonalMatrix<T> tridiagonal(n);
+                for (int i = 0; i < n; ++i) {
+                    tridiagonal.diagonal()[i] = A[i][i];
+                    if (i + 1 < n) {
+                        tridiagonal.lower()[i] = A[i + 1][i];
+                        tridiagonal.upper()[i] = A[i][i + 1];
+                    }
+                }
+                return ThomasSolver<T>::solve(tridiagonal, b);
+            }
+            BandedMatrix<T> band = BandedMatrix<T>::fromRows(A, s.lowerBandwidth, s.upperBandwidth);
+            if (s.symmetric && s.positiveDiagonal) {
+                try {
+                    auto factorization = BandedCholesky<T>::factor(band);
+                    record(Path::BandedCholesky);
+                    return factorization.solve(b);
+                } catch (const std::runtime_error&) {
+                    // Not positive definite after all; the pivoted band solver handles it
+                }
+            }
+            record(Path::BandedLU);
+            return BandedLU<T>::solve(band, b);
+        }
+
+        if (s.symmetric && s.positiveDiagonal) {
+            std::vector<std::vector<T>> L;
+            if (tryCholesky(A, L)) {
+                record(Path::Cholesky);
+                return choleskySubstitution(L, b);
+            }
+        }
+        record(Path::PivotedLU);
+        return GaussianEliminationSolver<T>::solve(A, b);
+    }
+
+    static Path lastPath() {
+        return lastPathSlot();
+    }
+
+    static const char* name(Path path) {
+        switch (path) {
+            case Path::Diagonal: return "Diagonal";
+            case Path::LowerTriangular: return "LowerTriangular";
+            case Path::UpperTriangular: return "UpperTriangular";
+            case Path::Tridiagonal: return "Tridiagonal";
+            case Path::BandedCholesky: return "BandedCholesky";
+            case Path::BandedLU: return "BandedLU";
+            case Path::Cholesky: return "Cholesky";
+            case Path::PivotedLU: return "PivotedLU";
+        }
+        return "Unknown";
+    }
+
+private:
+    static Path& lastPathSlot() {
+        thread_local Path path = Path::PivotedLU;
+        return path;
+    }
+
+    static void record(Path path) {
+        lastPathSlot() = path;
+    }
+
+    // Same singularity threshold as GaussianEliminationSolver, so each path rejects the same systems
+    static const T& pivot(const T& value) {
+        if (std::abs(value) < 1e-9) {
+            throw std::runtime_error("Singular matrix encountered during substitution.");
+        }
+        return value;
+    }
+
+    // Stops at the first pivot that is not positive instead of taking the root of it
+    template<RowIndexable<T> Rows>
+    static bool tryCholesky(const Rows& A, std::vector<std::vector<T>>& L) {
+        int n = A.size();
+        L.assign(n, std::vector<T>());
+        for (int i = 0; i < n; ++i) {
+            L[i].resize(i + 1);
+            for (int j = 0; j <= i; ++j) {
+                T sum = A[i][j];
+                for (int k = 0; k < j; ++k) {
+                    sum -= L[i][k] * L[j][k];
+                }
+                if (i == j) {
+                    if (!(sum > T(0))) {
+                        return false;
+                    }
+                    L[i][i] = std::sqrt(sum);
+                } else {
+                    L[i][j] = sum / L[j][j];
+                }
+            }
+        }
+        return true;
+    }
 
+    static std::vector<T> choleskySubstitution(const std::vector<std::vector<T>>& L, const std::vector<T>& b) {
+        int n = L.size();
+        std::vector<T> x(b);
+        for (int i = 0; i < n; ++i) {
+            for (int k = 0; k < i; ++k) {
+                x[i] -= L[i][k] * x[k];
+            }
+            x[i] /= L[i][i];
+        }
+        for (int i = n - 1; i >= 0; --i) {
+            for (int k = i + 1; k < n; ++k) {
+                x[i] -= L[k][i] * x[k];
+            }
+            x[i] /= L[i][i];
+        }
+        return x;
+    }
+};
 
+// Exact solution of an integer system as fractions: Bareiss elimination of [A | b], then
+// fraction-free back substitution for y = det * x, which is integral by Cramer's rule, so every
+// division is exact. The minors of [A | b] and det * x have to fit in T, and the products of
+// two of them, with their sums, in the wider type the kernels use for a built-in T;
+// std::overflow_error is thrown otherwise.
+template<typename T>
+class BareissSolver {
+public:
+    template<RowIndexable<T> Rows>
+    static std::vector<Rational<T>> solve(const Rows& A, const std::vector<T>& b) {
+        int n = A.size();
+        std::vector<std::vector<T>> augmented(n, std::vector<T>(n + 1));
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                augmented[i][j] = A[i][j];
+            }
+            augmented[i][n] = b[i];
+        }
+        if (BareissKernels<T>::eliminate(augmented, n) == 0) {
+            throw std::runtime_error("Singular matrix encountered during Bareiss elimination.");
+        }
+
+        const T& det = augmented[n - 1][n - 1];
+        std::vector<T> y = BareissKernels<T>::substitute(augmented, n);
 
+        std::vector<Rational<T>> x;
+        x.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            x.emplace_back(y[i], det);
+        }
+        return x;
+    }
+};
+
+// Exact solution of an integer system as fractions, computed modulo primes below 2^31 and
+// recombined by the Chinese remainder theorem: det(A) and det(A) * x, both bounded by the
+// Hadamard bound of [A | b], are recovered from their residues. Primes that divide det(A) are
+// skipped. det(A) and det(A) * x have to fit in T, std::overflow_error is thrown otherwise,
+// but the intermediate minors Bareiss goes through do not. The primes run in parallel.
+template<typename T>
+class ModularSolver {
+public:
+    template<RowIndexable<T> Rows>
+    static std::vector<Rational<T>> solve(const Rows& A, const std::vector<T>& b) {
+        int n = A.size();
+        std::vector<std::vector<T>> augmented(n, std::vector<T>(n + 1));
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                augmented[i][j] = A[i][j];
+            }
+            augmented[i][n] = b[i];
+        }
+        int needed = ModularArithmetic::primesFor(ModularArithmetic::hadamardBits<T>(augmented));
+
+        // If det(A) were nonzero, it could not be divisible by `needed` of the primes
+        std::vector<long long> primes;
+        std::vector<long long> detResidues;
+        std::vector<std::vector<long long>> yResidues(n);
+        int nextPrime = 0;
+        int unlucky = 0;
+        while (static_cast<int>(primes.size()) < needed) {
+            int batch = needed - static_cast<int>(primes.size());
+            std::vector<long long> batchPrimes(batch);
+            std::vector<long long> batchDets(batch);
+            std::vector<std::vector<long long>> batchYs(batch);
+            for (int t = 0; t < batch; ++t) {
+                batchPrimes[t] = ModularArithmetic::prime(nextPrime + t);
+            }
+            MatrixExecutor::current().parallelFor(batch, [&](int t) {
+                long long p = batchPrimes[t];
+                auto reduced = ModularArithmetic::residues<T>(A, p);
+                std::vector<long long> x(n);
+                for (int i = 0; i < n; ++i) {
+                    x[i] = ModularArithmetic::residue(b[i], p);
+                }
+                batchDets[t] = ModularArithmetic::solve(reduced, &x, p);
+                for (long long& value : x) {
+                    value = ModularArithmetic::multiply(value, batchDets[t], p);
+                }
+                batchYs[t] = std::move(x);
+            });
+            nextPrime += batch;
+
+            for (int t = 0; t < batch; ++t) {
+                if (batchDets[t] == 0) {
+                    ++unlucky;
+                    continue;
+                }
+                primes.push_back(batchPrimes[t]);
+                detResidues.push_back(batchDets[t]);
+                for (int i = 0; i < n; ++i) {
+                    yResidues[i].push_back(batchYs[t][i]);
+                }
+            }
+            if (unlucky >= needed) {
+                throw std::runtime_error("Singular matrix encountered during modular solve.");
+            }
+        }
+
+        T det = ModularArithmetic::reconstruct<T>(detResidues, primes);
+        std::vector<Rational<T>> x;
+        x.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            x.emplace_back(ModularArithmetic::reconstruct<T>(yResidues[i], primes), det);
+        }
+        return x;
+    }
+};
 
 #endif // SOLVING_POLICIES_HPP
@@ -0,0 +1,262 @@
+#ifndef TASK_GRAPH_HPP
+#define TASK_GRAPH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "Concepts.hpp"
+#include "Executor.hpp"
+
+// A dependency graph of tasks, built the way PLASMA-style tile algorithms are written:
+// tasks are added in sequential program order together with the data they read and write,
+// and the graph derives the read-after-write, write-after-read and write-after-write edges.
+// run() then starts every task as soon as its inputs are ready, so independent work from
+// different steps of the algorithm overlaps instead of waiting at a barrier.
+class TaskGraph {
+public:
+    enum class Access {
+        Read,
+        Write
+    };
+
+    struct Dependency {
+        const void* data;
+        Access access;
+    };
+
+    static Dependency reads(const void* data) {
+        return {data, Access::Read};
+    }
+
+    // Read-modify-write counts as a write
+    static Dependency writes(const void* data) {
+        return {data, Access::Write};
+    }
+
+    // Adds a task after all tasks added so far that touch the same data in a conflicting way
+    void add(std::function<void()> work, std::initializer_list<Dependency> data) {
+        addTask(std::move(work), data.begin(), data.end());
+    }
+
+    // The same for data only known at run time, like a whole column of tiles
+    void add(std::function<void()> work, const std::vector<Dependency>& data) {
+        addTask(std::move(work), data.data(), data.data() + data.size());
+    }
+
+    std::size_t size() const {
+        return nodes.size();
+    }
+
+    // Runs every task on `executor` and returns when all have finished; the calling thread helps.
+    // If a task throws, the tasks that have not started yet are skipped and the first
+    // exception is rethrown here. A graph runs once.
+    void run(MatrixExecutor& executor = MatrixExecutor::current()) {
+        if (nodes.empty()) {
+            return;
+        }
+        remaining.store(nodes.size(), std::memory_order_relaxed);
+        for (Node& node : nodes) {
+            node.pending.store(node.dependencies, std::memory_order_relaxed);
+        }
+        for (std::size_t id = 0; id < nodes.size(); ++id) {
+            if (nodes[id].dependencies == 0) {
+                schedule(executor, static_cast<int>(id));
+            }
+        }
+
+        // finished is only read and written under doneMutex, so once it is seen the last task
+        // has released the mutex and no longer touches the graph
+        for (;;) {
+            if (executor.runOne()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(doneMutex);
+            if (done.wait_for(lock, std::chrono::microseconds(200), [this] { return finished; })) {
+                break;
+            }
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+private:
+    struct Node {
+        std::function<void()> work;
+        std::vector<int> successors;
+        int dependencies = 0;
+        std::atomic<int> pending{0};
+    };
+
+    struct DataState {
+        int lastWriter = -1;
+        std::vector<int> readers;
+    };
+
+    void addTask(std::function<void()> work, const Dependency* first, const Dependency* last) {
+        int id = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+        nodes.back().work = std::move(work);
+
+        for (const Dependency* dependency = first; dependency != last; ++dependency) {
+            DataState& state = states[dependency->data];
+            if (state.lastWriter >= 0) {
+                addEdge(state.lastWriter, id);
+            }
+            if (dependency->access == Access::Read) {
+                state.readers.push_back(id);
+            } else {
+                for (int reader : state.readers) {
+                    addEdge(reader, id);
+                }
+                state.readers.clear();
+                state.lastWriter = id;
+            }
+        }
+    }
+
+    void addEdge(int from, int to) {
+        std::vector<int>& successors = nodes[from].successors;
+        if (successors.empty() || successors.back() != to) {
+            successors.push_back(to);
+            ++nodes[to].dependencies;
+        }
+    }
+
+    void schedule(MatrixExecutor& executor, int id) {
+        executor.push([this, &executor, id] { execute(executor, id); });
+    }
+
+    void execute(MatrixExecutor& executor, int id) {
+        Node& node = nodes[id];
+        if (!failed.load(std::memory_order_acquire)) {
+            try {
+                node.work();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+                failed.store(true, std::memory_order_release);
+            }
+        }
+        for (int successor : node.successors) {
+            if (nodes[successor].pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                schedule(executor, successor);
+            }
+        }
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            finished = true;
+            done.notify_all();
+        }
+    }
+
+    std::deque<Node> nodes;
+    std::unordered_map<const void*, DataState> states;
+    std::atomic<std::size_t> remaining{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr failure;
+    bool finished = false;
+    std::mutex doneMutex;
+    std::condition_variable done;
+};
+
+// A matrix split into square tiles of tileSize x tileSize, each stored contiguously in
+// row-major order, so a tile is one unit of data for TaskGraph. Edge tiles are stored at full
+// size with zeros outside the matrix; tileHeight() and tileWidth() give the part that lies
+// inside it, which is all the tile kernels work on.
+template<typename T>
+class TileGrid {
+public:
+    template<RowIndexable<T> Rows>
+    TileGrid(const Rows& matrix, int tileSize)
+        : TileGrid(matrix.size(), matrix.size() > 0 ? matrix[0].size() : 0, tileSize) {
+        for (int i = 0; i < rowCount; ++i) {
+            for (int j = 0; j < colCount; ++j) {
+                (*this)(i, j) = matrix[i][j];
+            }
+        }
+    }
+
+    TileGrid(int rows, int cols, int tileSize)
+        : rowCount(rows), colCount(cols), size(validTileSize(tileSize)),
+          tilesDown((rows + size - 1) / size), tilesAcross((cols + size - 1) / size),
+          elements(static_cast<std::size_t>(tilesDown) * tilesAcross * size * size, T(0)) {}
+
+    T* tile(int i, int j) {
+        return elements.data() + (static_cast<std::size_t>(i) * tilesAcross + j) * size * size;
+    }
+
+    T& operator()(int i, int j) {
+        return tile(i / size, j / size)[(i % size) * size + j % size];
+    }
+
+    int rows() const {
+        return rowCount;
+    }
+
+    int cols() const {
+        return colCount;
+    }
+
+    int tileRows() const {
+        return tilesDown;
+    }
+
+    int tileCols() const {
+        return tilesAcross;
+    }
+
+    int tileSize() const {
+        return size;
+    }
+
+    // Rows of tile row i and columns of tile column j that lie inside the matrix
+    int tileHeight(int i) const {
+        return std::min(size, rowCount - i * size);
+    }
+
+    int tileWidth(int j) const {
+        return std::min(size, colCount - j * size);
+    }
+
+    // The rows x cols matrix without padding
+    std::vector<std::vector<T>> toVectorMatrix() {
+        std::vector<std::vector<T>> result(rowCount, std::vector<T>(colCount));
+        for (int i = 0; i < rowCount; ++i) {
+            for (int j = 0; j < colCount; ++j) {
+                result[i][j] = (*this)(i, j);
+            }
+        }
+        return result;
+    }
+
+private:
+    static int validTileSize(int tileSize) {
+        if (tileSize < 1) {
+            throw std::invalid_argument("Tile size must be positive.");
+        }
+        return tileSize;
+    }
+
+    int rowCount;
+    int colCount;
+    int size;
+    int tilesDown;
+    int tilesAcross;
+    std::vector<T> elements;
+};
+
+#endif // TASK_GRAPH_HPP
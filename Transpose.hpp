@@ -0,0 +1,175 @@
+#ifndef TRANSPOSE_HPP
+#define TRANSPOSE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Executor.hpp"
+
+#ifndef MATRIX_HAS_SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MATRIX_HAS_SSE2 1
+#else
+#define MATRIX_HAS_SSE2 0
+#endif
+#endif
+
+// Transposes of dense blocks given as (pointer, row stride). The recursion halves the longer
+// side until a tile fits in L1, so both the reads and the strided writes stay cache friendly
+// at every level of the memory hierarchy without tuning for a particular cache size. Tiles of
+// float and double are transposed in SSE registers where available.
+template<typename T>
+class TransposeKernels {
+public:
+    static constexpr int TileSize = 16;
+    // Below this many elements the work is not worth handing to other threads
+    static constexpr std::size_t ParallelElements = std::size_t(1) << 20;
+
+    // destination (cols x rows) = transpose of source (rows x cols)
+    static void outOfPlace(const T* source, std::ptrdiff_t sourceStride, T* destination, std::ptrdiff_t destinationStride, int rows, int cols) {
+        MatrixExecutor& executor = MatrixExecutor::current();
+        int bands = bandCount(executor, static_cast<std::size_t>(rows) * cols);
+        if (bands <= 1) {
+            recurse(source, sourceStride, destination, destinationStride, rows, cols);
+            return;
+        }
+
+        // Bands of source rows become disjoint bands of destination columns
+        int band = (rows + bands - 1) / bands;
+        band = (band + TileSize - 1) / TileSize * TileSize;
+        executor.parallelFor((rows + band - 1) / band, [=](int index) {
+            int start = index * band;
+            recurse(source + start * sourceStride, sourceStride, destination + start, destinationStride, std::min(band, rows - start), cols);
+        });
+    }
+
+    // Transposes the n x n block at `matrix` in place
+    static void inPlace(T* matrix, std::ptrdiff_t stride, int n) {
+        MatrixExecutor& executor = MatrixExecutor::current();
+        if (n <= TileSize || bandCount(executor, static_cast<std::size_t>(n) * n) <= 1) {
+            inPlaceRecurse(matrix, stride, n);
+            return;
+        }
+
+        // The two diagonal blocks and the off-diagonal pair touch disjoint elements
+        int half = n / 2;
+        executor.parallelFor(3, [=](int part) {
+            if (part == 0) {
+                inPlaceRecurse(matrix, stride, half);
+            } else if (part == 1) {
+                inPlaceRecurse(matrix + half * stride + half, stride, n - half);
+            } else {
+                swapRecurse(matrix + half, matrix + half * stride, stride, half, n - half);
+            }
+        });
+    }
+
+private:
+    static int bandCount(const MatrixExecutor& executor, std::size_t elements) {
+        if (elements < ParallelElements || executor.inWorker()) {
+            return 1;
+        }
+        return static_cast<int>(std::min<std::size_t>(executor.threadCount(), elements / (ParallelElements / 4)));
+    }
+
+    static void recurse(const T* source, std::ptrdiff_t sourceStride, T* destination, std::ptrdiff_t destinationStride, int rows, int cols) {
+        if (rows <= TileSize && cols <= TileSize) {
+            tile(source, sourceStride, destination, destinationStride, rows, cols);
+        } else if (rows >= cols) {
+            int half = rows / 2;
+            recurse(source, sourceStride, destination, destinationStride, half, cols);
+            recurse(source + half * sourceStride, sourceStride, destination + half, destinationStride, rows - half, cols);
+        } else {
+            int half = cols / 2;
+            recurse(source, sourceStride, destination, destinationStride, rows, half);
+            recurse(source + half, sourceStride, destination + half * destinationStride, destinationStride, rows, cols - half);
+        }
+    }
+
+    static void tile(const T* source, std::ptrdiff_t sourceStride, T* destination, std::ptrdiff_t destinationStride, int rows, int cols) {
+        int i = 0;
+#if MATRIX_HAS_SSE2
+        if constexpr (std::is_same_v<T, float>) {
+            for (; i + 4 <= rows; i += 4) {
+                int j = 0;
+                for (; j + 4 <= cols; j += 4) {
+                    const float* s = source + i * sourceStride + j;
+                    __m128 r0 = _mm_loadu_ps(s);
+                    __m128 r1 = _mm_loadu_ps(s + sourceStride);
+                    __m128 r2 = _mm_loadu_ps(s + 2 * sourceStride);
+                    __m128 r3 = _mm_loadu_ps(s + 3 * sourceStride);
+                    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                    float* d = destination + j * destinationStride + i;
+                    _mm_storeu_ps(d, r0);
+                    _mm_storeu_ps(d + destinationStride, r1);
+                    _mm_storeu_ps(d + 2 * destinationStride, r2);
+                    _mm_storeu_ps(d + 3 * destinationStride, r3);
+                }
+                scalar(source + i * sourceStride + j, sourceStride, destination + j * destinationStride + i, destinationStride, 4, cols - j);
+            }
+        } else if constexpr (std::is_same_v<T, double>) {
+            for (; i + 2 <= rows; i += 2) {
+                int j = 0;
+                for (; j + 2 <= cols; j += 2) {
+                    const double* s = source + i * sourceStride + j;
+                    __m128d r0 = _mm_loadu_pd(s);
+                    __m128d r1 = _mm_loadu_pd(s + sourceStride);
+                    double* d = destination + j * destinationStride + i;
+                    _mm_storeu_pd(d, _mm_unpacklo_pd(r0, r1));
+                    _mm_storeu_pd(d + destinationStride, _mm_unpackhi_pd(r0, r1));
+                }
+                scalar(source + i * sourceStride + j, sourceStride, destination + j * destinationStride + i, destinationStride, 2, cols - j);
+            }
+        }
+#endif
+        scalar(source + i * sourceStride, sourceStride, destination + i, destinationStride, rows - i, cols);
+    }
+
+    static void scalar(const T* source, std::ptrdiff_t sourceStride, T* destination, std::ptrdiff_t destinationStride, int rows, int cols) {
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                destination[j * destinationStride + i] = source[i * sourceStride + j];
+            }
+        }
+    }
+
+    static void inPlaceRecurse(T* matrix, std::ptrdiff_t stride, int n) {
+        if (n <= TileSize) {
+            for (int i = 0; i < n; ++i) {
+                for (int j = i + 1; j < n; ++j) {
+                    std::swap(matrix[i * stride + j], matrix[j * stride + i]);
+                }
+            }
+            return;
+        }
+        int half = n / 2;
+        inPlaceRecurse(matrix, stride, half);
+        inPlaceRecurse(matrix + half * stride + half, stride, n - half);
+        swapRecurse(matrix + half, matrix + half * stride, stride, half, n - half);
+    }
+
+    // Swaps the rows x cols block `upper` with the transpose of the cols x rows block `lower`
+    static void swapRecurse(T* upper, T* lower, std::ptrdiff_t stride, int rows, int cols) {
+        if (rows <= TileSize && cols <= TileSize) {
+            for (int i = 0; i < rows; ++i) {
+                for (int j = 0; j < cols; ++j) {
+                    std::swap(upper[i * stride + j], lower[j * stride + i]);
+                }
+            }
+        } else if (rows >= cols) {
+            int half = rows / 2;
+            swapRecurse(upper, lower, stride, half, cols);
+            swapRecurse(upper + half * stride, lower + half, stride, rows - half, cols);
+        } else {
+            int half = cols / 2;
+            swapRecurse(upper, lower, stride, rows, half);
+            swapRecurse(upper + half, lower + half * stride, stride, rows, cols - half);
+        }
+    }
+};
+
+#endif // TRANSPOSE_HPP
@@ -0,0 +1,176 @@
+#ifndef WORKSPACE_HPP
+#define WORKSPACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+// Scratch memory for policy internals. Policies allocate their temporaries from
+// workspaceResource(), which is the resource installed by the innermost WorkspaceScope
+// or, by default, a thread-local arena. The arena never frees individual allocations;
+// every WorkspaceScope rewinds it to where it was when the scope opened, so workspace
+// containers must not outlive the scope they were created in. Once the arena has grown
+// to a call's peak, repeating the call does not touch the global heap at all.
+
+class WorkspaceArena : public std::pmr::memory_resource {
+public:
+    explicit WorkspaceArena(std::size_t initialBlockSize = 64 * 1024) : initialBlockSize(initialBlockSize) {}
+
+    ~WorkspaceArena() override {
+        for (const Block& block : blocks) {
+            ::operator delete(block.data);
+        }
+    }
+
+    WorkspaceArena(const WorkspaceArena&) = delete;
+    WorkspaceArena& operator=(const WorkspaceArena&) = delete;
+
+    static WorkspaceArena& forThisThread() {
+        thread_local WorkspaceArena arena;
+        return arena;
+    }
+
+    // Makes all memory reusable. If the last round needed several blocks they are merged
+    // into one, so the next round of the same size fits in a single block.
+    void reset() {
+        if (blocks.size() > 1) {
+            std::size_t total = 0;
+            for (const Block& block : blocks) {
+                total += block.size;
+                ::operator delete(block.data);
+            }
+            blocks.clear();
+            blocks.push_back({static_cast<std::byte*>(::operator new(total)), total});
+        }
+        current = 0;
+        offset = 0;
+    }
+
+    struct Position {
+        std::size_t block;
+        std::size_t offset;
+    };
+
+    Position position() const {
+        return {current, offset};
+    }
+
+    // Frees everything allocated since `mark` was taken
+    void rewind(Position mark) {
+        current = mark.block;
+        offset = mark.offset;
+    }
+
+    std::size_t capacity() const {
+        std::size_t total = 0;
+        for (const Block& block : blocks) {
+            total += block.size;
+        }
+        return total;
+    }
+
+private:
+    struct Block {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        while (current < blocks.size()) {
+            Block& block = blocks[current];
+            std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block.data + offset);
+            std::size_t padding = (alignment - address % alignment) % alignment;
+            if (offset + padding + bytes <= block.size) {
+                void* result = block.data + offset + padding;
+                offset += padding + bytes;
+                return result;
+            }
+            ++current;
+            offset = 0;
+        }
+        std::size_t size = blocks.empty() ? initialBlockSize : 2 * blocks.back().size;
+        if (size < bytes + alignment) {
+            size = bytes + alignment;
+        }
+        blocks.push_back({static_cast<std::byte*>(::operator new(size)), size});
+        current = blocks.size() - 1;
+        return do_allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::size_t initialBlockSize;
+    std::vector<Block> blocks;
+    std::size_t current = 0;
+    std::size_t offset = 0;
+};
+
+class WorkspaceScope {
+public:
+    // nullptr keeps the enclosing scope's resource (the thread-local arena at top level)
+    explicit WorkspaceScope(std::pmr::memory_resource* resource = nullptr)
+        : previous(state().resource), mark(WorkspaceArena::forThisThread().position()) {
+        if (resource != nullptr) {
+            state().resource = resource;
+        }
+        ++state().depth;
+    }
+
+    ~WorkspaceScope() {
+        if (--state().depth == 0) {
+            WorkspaceArena::forThisThread().reset();
+        } else {
+            WorkspaceArena::forThisThread().rewind(mark);
+        }
+        state().resource = previous;
+    }
+
+    WorkspaceScope(const WorkspaceScope&) = delete;
+    WorkspaceScope& operator=(const WorkspaceScope&) = delete;
+
+private:
+    friend std::pmr::memory_resource* workspaceResource();
+
+    struct State {
+        std::pmr::memory_resource* resource = nullptr;
+        int depth = 0;
+    };
+
+    static State& state() {
+        thread_local State current;
+        return current;
+    }
+
+    std::pmr::memory_resource* previous;
+    WorkspaceArena::Position mark;
+};
+
+inline std::pmr::memory_resource* workspaceResource() {
+    std::pmr::memory_resource* resource = WorkspaceScope::state().resource;
+    return resource != nullptr ? resource : &WorkspaceArena::forThisThread();
+}
+
+template<typename T>
+using WorkspaceVector = std::pmr::vector<T>;
+
+template<typename T>
+using WorkspaceMatrix = std::pmr::vector<std::pmr::vector<T>>;
+
+template<typename T>
+WorkspaceVector<T> makeWorkspaceVector(int size) {
+    return WorkspaceVector<T>(size, T(), workspaceResource());
+}
+
+template<typename T>
+WorkspaceMatrix<T> makeWorkspaceMatrix(int rows, int cols) {
+    std::pmr::memory_resource* resource = workspaceResource();
+    return WorkspaceMatrix<T>(rows, WorkspaceVector<T>(cols, T(), resource), resource);
+}
+
+#endif // WORKSPACE_HPP
@@ -0,0 +1,263 @@
+#ifndef BENCHMARK_HARNESS_HPP
+#define BENCHMARK_HARNESS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "PerfCounters.hpp"
+
+// Heap traffic seen by the replaced global operator new/delete in MatrixBench.cpp.
+struct AllocationCounters {
+    static inline std::atomic<std::size_t> allocations{0};
+    static inline std::atomic<std::size_t> bytesAllocated{0};
+    static inline std::atomic<std::size_t> liveBytes{0};
+    static inline std::atomic<std::size_t> peakLiveBytes{0};
+
+    static void recordAllocation(std::size_t bytes) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+        std::size_t live = liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        std::size_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+        while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void recordDeallocation(std::size_t bytes) {
+        liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+};
+
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct BenchmarkResult {
+    std::string operation;
+    std::string policy;
+    std::string type;
+    int size = 0;
+    int repetitions = 0;
+    double flops = 0;
+    double minNs = 0;
+    double meanNs = 0;
+    double p50Ns = 0;
+    double p90Ns = 0;
+    double p99Ns = 0;
+    double maxNs = 0;
+    double gflops = 0;
+    std::size_t allocationsPerCall = 0;
+    std::size_t bytesAllocatedPerCall = 0;
+    std::size_t peakHeapBytes = 0;
+    long peakRssKb = 0;
+    PerfSample perfPerCall;
+};
+
+struct BenchmarkOptions {
+    std::vector<int> sizes = {4, 8, 16, 32, 64, 128, 256};
+    std::vector<std::string> types = {"float", "double"};
+    std::string filter;
+    std::string jsonPath;
+    double minSeconds = 0.2;
+    int minRepetitions = 5;
+    int maxRepetitions = 1000;
+    bool perfCounters = false;
+};
+
+class BenchmarkHarness {
+public:
+    explicit BenchmarkHarness(BenchmarkOptions options) : options(std::move(options)) {}
+
+    const BenchmarkOptions& settings() const {
+        return options;
+    }
+
+    bool selected(const std::string& operation, const std::string& policy) const {
+        return options.filter.empty() || (operation + "/" + policy).find(options.filter) != std::string::npos;
+    }
+
+    // Times `call` until both the repetition and wall-time minimums are met.
+    // `flops` is the nominal count for the operation, so GFLOP/s compare policies of one operation.
+    void run(const std::string& operation, const std::string& policy, const std::string& type, int size, double flops, const std::function<void()>& call) {
+        using Clock = std::chrono::steady_clock;
+
+        call();
+
+        std::size_t allocationsBefore = AllocationCounters::allocations.load();
+        std::size_t bytesBefore = AllocationCounters::bytesAllocated.load();
+        std::size_t liveBefore = AllocationCounters::liveBytes.load();
+        AllocationCounters::peakLiveBytes.store(liveBefore);
+        call();
+        std::size_t allocationsPerCall = AllocationCounters::allocations.load() - allocationsBefore;
+        std::size_t bytesPerCall = AllocationCounters::bytesAllocated.load() - bytesBefore;
+        std::size_t peakHeap = AllocationCounters::peakLiveBytes.load() - liveBefore;
+
+        std::vector<double> samples;
+        std::optional<PerfMeasurement> perf;
+        if (options.perfCounters) {
+            perf.emplace();
+        }
+        auto start = Clock::now();
+        while (static_cast<int>(samples.size()) < options.maxRepetitions) {
+            auto begin = Clock::now();
+            call();
+            auto end = Clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(end - begin).count());
+
+            double elapsed = std::chrono::duration<double>(end - start).count();
+            if (static_cast<int>(samples.size()) >= options.minRepetitions && elapsed >= options.minSeconds) {
+                break;
+            }
+        }
+        PerfSample perfTotal;
+        if (perf) {
+            perfTotal = perf->elapsed();
+        }
+        std::sort(samples.begin(), samples.end());
+
+        BenchmarkResult result;
+        result.operation = operation;
+        result.policy = policy;
+        result.type = type;
+        result.size = size;
+        result.repetitions = static_cast<int>(samples.size());
+        result.flops = flops;
+        result.minNs = samples.front();
+        result.maxNs = samples.back();
+        double total = 0;
+        for (double sample : samples) {
+            total += sample;
+        }
+        result.meanNs = total / samples.size();
+        result.p50Ns = percentile(samples, 0.50);
+        result.p90Ns = percentile(samples, 0.90);
+        result.p99Ns = percentile(samples, 0.99);
+        result.gflops = flops > 0 ? flops / result.p50Ns : 0;
+        result.allocationsPerCall = allocationsPerCall;
+        result.bytesAllocatedPerCall = bytesPerCall;
+        result.peakHeapBytes = peakHeap;
+        result.peakRssKb = peakRssKb();
+        result.perfPerCall = perfTotal;
+        for (std::uint64_t& value : result.perfPerCall.values) {
+            value /= samples.size();
+        }
+
+        print(result);
+        results.push_back(result);
+    }
+
+    const std::vector<BenchmarkResult>& collected() const {
+        return results;
+    }
+
+    void printHeader() const {
+        std::cout << std::left << std::setw(14) << "operation" << std::setw(34) << "policy" << std::setw(8) << "type"
+                  << std::right << std::setw(6) << "n" << std::setw(8) << "reps" << std::setw(14) << "p50 [us]"
+                  << std::setw(14) << "p90 [us]" << std::setw(14) << "p99 [us]" << std::setw(10) << "GFLOP/s"
+                  << std::setw(10) << "allocs" << std::setw(14) << "peak heap";
+        if (options.perfCounters) {
+            std::cout << std::setw(14) << "cycles" << std::setw(8) << "IPC" << std::setw(12) << "L1D miss" << std::setw(12) << "LLC miss"
+                      << std::setw(12) << "br miss";
+        }
+        std::cout << "\n";
+    }
+
+    std::string toJson() const {
+        std::ostringstream os;
+        os << std::setprecision(10);
+        os << "{\n  \"results\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult& r = results[i];
+            os << "    {\"operation\": \"" << r.operation << "\", \"policy\": \"" << r.policy << "\", \"type\": \"" << r.type
+               << "\", \"size\": " << r.size << ", \"repetitions\": " << r.repetitions << ", \"flops\": " << r.flops
+               << ", \"time_ns\": {\"min\": " << r.minNs << ", \"mean\": " << r.meanNs << ", \"p50\": " << r.p50Ns
+               << ", \"p90\": " << r.p90Ns << ", \"p99\": " << r.p99Ns << ", \"max\": " << r.maxNs << "}"
+               << ", \"gflops\": " << r.gflops
+               << ", \"memory\": {\"allocations_per_call\": " << r.allocationsPerCall
+               << ", \"bytes_allocated_per_call\": " << r.bytesAllocatedPerCall
+               << ", \"peak_heap_bytes\": " << r.peakHeapBytes << ", \"peak_rss_kb\": " << r.peakRssKb << "}";
+            if (options.perfCounters) {
+                os << ", \"perf_per_call\": {";
+                bool first = true;
+                for (std::size_t c = 0; c < PerfCounterCount; ++c) {
+                    os << (first ? "" : ", ") << "\"" << perfCounterName(static_cast<PerfCounter>(c)) << "\": ";
+                    if (r.perfPerCall.available[c]) {
+                        os << r.perfPerCall.values[c];
+                    } else {
+                        os << "null";
+                    }
+                    first = false;
+                }
+                os << "}";
+            }
+            os << "}";
+            os << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        os << "  ]\n}\n";
+        return os.str();
+    }
+
+private:
+    static double percentile(const std::vector<double>& sorted, double fraction) {
+        double position = fraction * (sorted.size() - 1);
+        std::size_t lower = static_cast<std::size_t>(position);
+        std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+        double weight = position - lower;
+        return sorted[lower] * (1 - weight) + sorted[upper] * weight;
+    }
+
+    static long peakRssKb() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    void print(const BenchmarkResult& r) const {
+        std::cout << std::left << std::setw(14) << r.operation << std::setw(34) << r.policy << std::setw(8) << r.type
+                  << std::right << std::setw(6) << r.size << std::setw(8) << r.repetitions << std::fixed << std::setprecision(2)
+                  << std::setw(14) << r.p50Ns / 1e3 << std::setw(14) << r.p90Ns / 1e3 << std::setw(14) << r.p99Ns / 1e3
+                  << std::setw(10) << r.gflops << std::setw(10) << r.allocationsPerCall << std::setw(14) << r.peakHeapBytes;
+        if (options.perfCounters) {
+            const PerfSample& p = r.perfPerCall;
+            printCounter(p, PerfCounter::Cycles, 14);
+            if (p.has(PerfCounter::Cycles) && p.has(PerfCounter::Instructions) && p[PerfCounter::Cycles] > 0) {
+                std::cout << std::setw(8) << static_cast<double>(p[PerfCounter::Instructions]) / p[PerfCounter::Cycles];
+            } else {
+                std::cout << std::setw(8) << "n/a";
+            }
+            printCounter(p, PerfCounter::L1DataMisses, 12);
+            printCounter(p, PerfCounter::LastLevelCacheMisses, 12);
+            printCounter(p, PerfCounter::BranchMisses, 12);
+        }
+        std::cout << std::defaultfloat << "\n";
+    }
+
+    static void printCounter(const PerfSample& sample, PerfCounter counter, int width) {
+        if (sample.has(counter)) {
+            std::cout << std::setw(width) << sample[counter];
+        } else {
+            std::cout << std::setw(width) << "n/a";
+        }
+    }
+
+    BenchmarkOptions options;
+    std::vector<BenchmarkResult> results;
+};
+
+#endif // BENCHMARK_HARNESS_HPP
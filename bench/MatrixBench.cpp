@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "AutoTuning.hpp"
+#include "BandedMatrix.hpp"
+#include "BenchmarkHarness.hpp"
+#include "Matrix.hpp"
+
+//====================ALLOCATION TRACKING====================================
+
+namespace {
+
+constexpr std::size_t AllocationHeader = alignof(std::max_align_t);
+
+void* trackedAllocate(std::size_t size) {
+    void* raw = std::malloc(size + AllocationHeader);
+    if (!raw) {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t*>(raw) = size;
+    AllocationCounters::recordAllocation(size);
+    return static_cast<char*>(raw) + AllocationHeader;
+}
+
+void trackedDeallocate(void* pointer) noexcept {
+    if (!pointer) {
+        return;
+    }
+    char* raw = static_cast<char*>(pointer) - AllocationHeader;
+    AllocationCounters::recordDeallocation(*reinterpret_cast<std::size_t*>(raw));
+    std::free(raw);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return trackedAllocate(size); }
+void* operator new[](std::size_t size) { return trackedAllocate(size); }
+void operator delete(void* pointer) noexcept { trackedDeallocate(pointer); }
+void operator delete[](void* pointer) noexcept { trackedDeallocate(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { trackedDeallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { trackedDeallocate(pointer); }
+
+//====================INPUTS====================================
+
+template<typename T>
+using Dense = std::vector<std::vector<T>>;
+
+template<typename T>
+Dense<T> randomMatrix(int n, std::mt19937& rng) {
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    Dense<T> matrix(n, std::vector<T>(n));
+    for (auto& row : matrix) {
+        for (T& value : row) {
+            value = static_cast<T>(distribution(rng));
+        }
+    }
+    return matrix;
+}
+
+// Symmetric and strictly diagonally dominant, so every policy (including the
+// non-pivoting LU variants and the iterative solvers) is well defined on it.
+template<typename T>
+Dense<T> spdMatrix(int n, std::mt19937& rng) {
+    Dense<T> matrix = randomMatrix<T>(n, rng);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < i; ++j) {
+            matrix[i][j] = matrix[j][i];
+        }
+        matrix[i][i] = static_cast<T>(n + 1);
+    }
+    return matrix;
+}
+
+//====================CASES====================================
+
+constexpr int FactorialPolicyLimit = 8;
+
+bool isPowerOfTwo(int n) {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+template<typename F>
+void add(BenchmarkHarness& harness, const std::string& operation, const std::string& policy, const std::string& type, int n, double flops, F&& call) {
+    if (harness.selected(operation, policy)) {
+        harness.run(operation, policy, type, n, flops, [&] { doNotOptimize(call()); });
+    }
+}
+
+template<typename T>
+void benchmarkType(BenchmarkHarness& harness, const std::string& type) {
+    std::mt19937 rng(42);
+
+    for (int n : harness.settings().sizes) {
+        Dense<T> A = spdMatrix<T>(n, rng);
+        Dense<T> B = randomMatrix<T>(n, rng);
+        std::vector<T> b = randomMatrix<T>(1, rng)[0];
+        b.resize(n, T(1));
+
+        double n3 = static_cast<double>(n) * n * n;
+        double multiplyFlops = 2 * n3;
+        double luFlops = 2 * n3 / 3;
+        double qrFlops = 4 * n3 / 3;
+        double choleskyFlops = n3 / 3;
+        double inverseFlops = 2 * n3;
+        double solveFlops = luFlops + 2.0 * n * n;
+
+        add(harness, "multiply", "StandardMatrixMultiplication", type, n, multiplyFlops, [&] { return StandardMatrixMultiplication<T>::calculate(A, B); });
+        if (isPowerOfTwo(n)) {
+            add(harness, "multiply", "DivideAndConquerMultiplication", type, n, multiplyFlops, [&] { return DivideAndConquerMultiplication<T>::calculate(A, B); });
+            add(harness, "multiply", "StrassenMultiplication", type, n, multiplyFlops, [&] { return StrassenMultiplication<T>::calculate(A, B); });
+        }
+        add(harness, "multiply", "BlockedMatrixMultiplication", type, n, multiplyFlops, [&] { return BlockedMatrixMultiplication<T>::calculate(A, B); });
+        add(harness, "multiply", "AutoTuned", type, n, multiplyFlops, [&] { return AutoTunedMultiplication<T>::calculate(A, B); });
+        add(harness, "multiply", "TransposedMultiplicationNT", type, n, multiplyFlops, [&] { return TransposedMultiplication<T>::nt(A, B); });
+        add(harness, "multiply", "TransposedMultiplicationTN", type, n, multiplyFlops, [&] { return TransposedMultiplication<T>::tn(A, B); });
+
+        add(harness, "gram", "TransposedMultiplicationTN", type, n, multiplyFlops / 2, [&] { return TransposedMultiplication<T>::tn(B, B); });
+        add(harness, "gram", "SymmetricRankK", type, n, multiplyFlops / 2, [&] { return SymmetricRankK<T>::ata(B); });
+
+        std::vector<T> flat(static_cast<std::size_t>(n) * n), flatTransposed(flat.size());
+        for (int i = 0; i < n; ++i) {
+            std::copy(B[i].begin(), B[i].end(), flat.begin() + static_cast<std::size_t>(i) * n);
+        }
+        add(harness, "transpose", "Naive", type, n, 0, [&] {
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    flatTransposed[static_cast<std::size_t>(j) * n + i] = flat[static_cast<std::size_t>(i) * n + j];
+                }
+            }
+            return flatTransposed[0];
+        });
+        add(harness, "transpose", "CacheOblivious", type, n, 0, [&] {
+            TransposeKernels<T>::outOfPlace(flat.data(), n, flatTransposed.data(), n, n, n);
+            return flatTransposed[0];
+        });
+        add(harness, "transpose", "InPlace", type, n, 0, [&] {
+            TransposeKernels<T>::inPlace(flat.data(), n, n);
+            return flat[1];
+        });
+
+        add(harness, "lu", "Doolittle", type, n, luFlops, [&] { return Doolittle<T>::calculate(A); });
+        add(harness, "lu", "Crout", type, n, luFlops, [&] { return Crout<T>::calculate(A); });
+        add(harness, "lu", "GaussianFullPivoting", type, n, luFlops, [&] { return GaussianFullPivoting<T>::calculate(A); });
+        add(harness, "lu", "AutoTuned", type, n, luFlops, [&] { return AutoTunedLU<T>::calculate(A); });
+        add(harness, "lu", "TiledLU", type, n, luFlops, [&] { return TiledLU<T>::calculate(A); });
+
+        add(harness, "qr", "GramSchmidt", type, n, qrFlops, [&] { return GramSchmidt<T>::calculate(A); });
+        add(harness, "qr", "Householder", type, n, qrFlops, [&] { return Householder<T>::calculate(A); });
+        add(harness, "qr", "Givens", type, n, qrFlops, [&] { return Givens<T>::calculate(A); });
+        add(harness, "qr", "AutoTuned", type, n, qrFlops, [&] { return AutoTunedQR<T>::calculate(A); });
+        add(harness, "qr", "TiledQR", type, n, qrFlops, [&] { return TiledQR<T>::calculate(A); });
+
+        add(harness, "cholesky", "Cholesky", type, n, choleskyFlops, [&] { return Cholesky<T>::calculate(A); });
+        add(harness, "cholesky", "RecursiveCholesky", type, n, choleskyFlops, [&] { return RecursiveCholesky<T>::calculate(A); });
+        add(harness, "cholesky", "AutoTuned", type, n, choleskyFlops, [&] { return AutoTunedCholesky<T>::calculate(A); });
+        add(harness, "cholesky", "TiledCholesky", type, n, choleskyFlops, [&] { return TiledCholesky<T>::calculate(A); });
+
+        // Each case adds and then removes the same rank-one term, so the factors stay those of A
+        Dense<T> choleskyFactor = Cholesky<T>::calculate(A);
+        auto luFactors = Doolittle<T>::calculate(A);
+        std::vector<T> negatedB(b);
+        for (T& value : negatedB) {
+            value = -value;
+        }
+        double updateFlops = 2 * 4.0 * n * n;
+        add(harness, "update", "CholeskyUpdate", type, n, updateFlops, [&] {
+            CholeskyUpdate<T>::update(choleskyFactor, b);
+            CholeskyUpdate<T>::downdate(choleskyFactor, b);
+            return choleskyFactor[0][0];
+        });
+        add(harness, "update", "LUUpdate", type, n, updateFlops, [&] {
+            LUUpdate<T>::update(std::get<0>(luFactors), std::get<1>(luFactors), b, b);
+            LUUpdate<T>::update(std::get<0>(luFactors), std::get<1>(luFactors), b, negatedB);
+            return std::get<1>(luFactors)[0][0];
+        });
+        StreamingQR<T> streamingQR(n);
+        for (int i = 0; i < n; ++i) {
+            streamingQR.appendRow(B[i], b[i]);
+        }
+        add(harness, "update", "StreamingQR", type, n, 2 * 3.0 * n * n, [&] {
+            streamingQR.appendRow(b, T(1));
+            streamingQR.removeRow(b, T(1));
+            return streamingQR.residualNorm();
+        });
+
+        double svdFlops = 8.0 * 3 * n3;
+        add(harness, "svd", "OneSidedJacobiSVD", type, n, svdFlops, [&] { return std::get<1>(OneSidedJacobiSVD<T>::calculate(B)); });
+        add(harness, "svd", "OneSidedJacobiSVDPreconditioned", type, n, svdFlops, [&] { return std::get<1>(OneSidedJacobiSVD<T, true>::calculate(B)); });
+        add(harness, "svd", "SingularValuesOnly", type, n, svdFlops / 2, [&] { return OneSidedJacobiSVD<T>::singularValues(B); });
+        int svdRank = std::max(1, n / 8);
+        double lowRankFlops = 4.0 * n * n * svdRank * 2;
+        add(harness, "svd", "RandomizedSVD", type, n, lowRankFlops, [&] { return std::get<1>(RandomizedSVD<T>::calculate(B, svdRank)); });
+        add(harness, "svd", "RandomizedSVDSparseSketch", type, n, lowRankFlops, [&] {
+            return std::get<1>(RandomizedSVD<T>::calculate(B, svdRank, 1, 10, RandomizedSVD<T>::Sketch::SparseSign));
+        });
+
+        if (n <= FactorialPolicyLimit) {
+            add(harness, "determinant", "LaplaceExpansion", type, n, luFlops, [&] { return LaplaceExpansion<T>::calculate(A); });
+        }
+        add(harness, "determinant", "GaussianElimination", type, n, luFlops, [&] { return GaussianElimination<T>::calculate(A); });
+
+        add(harness, "inverse", "RowReduction", type, n, inverseFlops, [&] { return RowReduction<T>::calculate(A); });
+        if (n <= FactorialPolicyLimit) {
+            add(harness, "inverse", "ClassicalAdjoint", type, n, inverseFlops, [&] { return ClassicalAdjoint<T>::calculate(A); });
+        }
+
+        add(harness, "solve", "GaussianEliminationSolver", type, n, solveFlops, [&] { return GaussianEliminationSolver<T>::solve(A, b); });
+        add(harness, "solve", "AutoSolver", type, n, solveFlops, [&] { return AutoSolver<T>::solve(A, b); });
+        add(harness, "solve", "LUDecomposition", type, n, solveFlops, [&] { return LUDecomposition<T>::solve(A, b); });
+        add(harness, "solve", "MixedPrecisionSolver", type, n, solveFlops, [&] { return MixedPrecisionSolver<T>::solve(A, b); });
+        add(harness, "solve", "CholeskySolver", type, n, solveFlops, [&] { return CholeskySolver<T>::solve(A, b); });
+        add(harness, "solve", "QRSolver", type, n, solveFlops, [&] { return QRSolver<T>::solve(A, b); });
+        add(harness, "solve", "JacobiSolver", type, n, solveFlops, [&] { return JacobiSolver<T>::solve(A, b, T(1e-5), 1000); });
+        add(harness, "solve", "GaussSeidelSolver", type, n, solveFlops, [&] { return GaussSeidelSolver<T>::solve(A, b, T(1e-5), 1000); });
+
+        // The tridiagonal part of A, which is diagonally dominant and so positive definite
+        TridiagonalMatrix<T> tridiagonal(n);
+        for (int i = 0; i < n; ++i) {
+            tridiagonal.diagonal()[i] = A[i][i];
+            if (i + 1 < n) {
+                tridiagonal.lower()[i] = A[i + 1][i];
+                tridiagonal.upper()[i] = A[i][i + 1];
+            }
+        }
+        BandedMatrix<T> band = tridiagonal.toBanded();
+        double tridiagonalFlops = 8.0 * n;
+        add(harness, "tridiagonal", "ThomasSolver", type, n, tridiagonalFlops, [&] { return ThomasSolver<T>::solve(tridiagonal, b); });
+        add(harness, "tridiagonal", "BandedLU", type, n, tridiagonalFlops, [&] { return BandedLU<T>::solve(band, b); });
+        add(harness, "tridiagonal", "BandedCholesky", type, n, tridiagonalFlops, [&] { return BandedCholesky<T>::solve(band, b); });
+    }
+}
+
+//====================COMMAND LINE====================================
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void printUsage() {
+    std::cout << "Usage: matrix_bench [options]\n"
+              << "  --sizes=4,8,...     matrix sizes to sweep\n"
+              << "  --types=float,double element types\n"
+              << "  --filter=TEXT       only run cases whose operation/policy contains TEXT\n"
+              << "  --json=PATH         write results as JSON (PATH '-' writes to stdout)\n"
+              << "  --min-time=SECONDS  minimum measured time per case\n"
+              << "  --min-reps=N        minimum repetitions per case\n"
+              << "  --max-reps=N        maximum repetitions per case\n"
+              << "  --perf              add per-call hardware counters (cycles, IPC, cache and branch misses)\n";
+}
+
+BenchmarkOptions parseOptions(int argc, char** argv) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        std::string key = argument.substr(0, argument.find('='));
+        std::string value = argument.find('=') == std::string::npos ? "" : argument.substr(argument.find('=') + 1);
+        if (value.empty() && key != "--help" && key != "--perf" && i + 1 < argc) {
+            value = argv[++i];
+        }
+
+        if (key == "--sizes") {
+            options.sizes.clear();
+            for (const std::string& size : splitList(value)) {
+                options.sizes.push_back(std::stoi(size));
+            }
+        } else if (key == "--types") {
+            options.types = splitList(value);
+        } else if (key == "--filter") {
+            options.filter = value;
+        } else if (key == "--json") {
+            options.jsonPath = value;
+        } else if (key == "--min-time") {
+            options.minSeconds = std::stod(value);
+        } else if (key == "--min-reps") {
+            options.minRepetitions = std::stoi(value);
+        } else if (key == "--max-reps") {
+            options.maxRepetitions = std::stoi(value);
+        } else if (key == "--perf") {
+            options.perfCounters = true;
+        } else if (key == "--help") {
+            printUsage();
+            std::exit(0);
+        } else {
+            throw std::invalid_argument("Unknown option: " + argument);
+        }
+    }
+    return options;
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << "\n";
+        printUsage();
+        return 1;
+    }
+
+    BenchmarkHarness harness(options);
+    bool jsonToStdout = options.jsonPath == "-";
+    std::streambuf* console = std::cout.rdbuf();
+    std::ostringstream discarded;
+    if (jsonToStdout) {
+        std::cout.rdbuf(discarded.rdbuf());
+    }
+
+    harness.printHeader();
+    for (const std::string& type : options.types) {
+        if (type == "float") {
+            benchmarkType<float>(harness, type);
+        } else if (type == "double") {
+            benchmarkType<double>(harness, type);
+        } else {
+            std::cerr << "Unsupported type: " << type << "\n";
+            return 1;
+        }
+    }
+
+    if (jsonToStdout) {
+        std::cout.rdbuf(console);
+        std::cout << harness.toJson();
+    } else if (!options.jsonPath.empty()) {
+        std::ofstream file(options.jsonPath);
+        file << harness.toJson();
+    }
+    return 0;
+}
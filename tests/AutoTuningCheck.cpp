@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "AutoTuning.hpp"
+
+// Runs every LU and QR candidate of the autotuner on the same inputs and compares each with
+// the first candidate, so the factors Matrix::luDecomposition and Matrix::qrDecomposition
+// return do not depend on which candidate wins the timing.
+
+namespace {
+
+using Dense = std::vector<std::vector<double>>;
+
+constexpr double Tolerance = 1e-9;
+
+double maxDifference(const Dense& a, const Dense& b) {
+    if (a.size() != b.size() || a[0].size() != b[0].size()) {
+        return INFINITY;
+    }
+    double difference = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        for (std::size_t j = 0; j < a[i].size(); ++j) {
+            difference = std::max(difference, std::abs(a[i][j] - b[i][j]));
+        }
+    }
+    return difference;
+}
+
+bool report(const char* operation, const char* candidate, int rows, int cols, double difference) {
+    bool passed = difference <= Tolerance;
+    std::printf("%-3s %-12s %3dx%-3d %s  max difference %.3e\n", operation, candidate, rows, cols, passed ? "ok    " : "FAILED", difference);
+    return passed;
+}
+
+bool checkLU(int n, std::mt19937& rng) {
+    Dense A = diagonallyDominantDense<double>(n, rng);
+    const auto& candidates = LUTuning<double>::candidates();
+    auto [L0, U0, rows0, cols0] = candidates[0].call(A);
+    bool passed = true;
+    for (const auto& candidate : candidates) {
+        auto [L, U, rowPermutation, colPermutation] = candidate.call(A);
+        double difference = std::max(maxDifference(L, L0), maxDifference(U, U0));
+        passed = report("lu", candidate.name, n, n, difference) && passed;
+    }
+    return passed;
+}
+
+bool checkQR(int rows, int cols, std::mt19937& rng) {
+    Dense A(rows, std::vector<double>(cols));
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    for (auto& row : A) {
+        for (double& value : row) {
+            value = distribution(rng);
+        }
+    }
+    const auto& candidates = QRTuning<double>::candidates();
+    auto [Q0, R0] = candidates[0].call(A);
+    bool passed = true;
+    for (const auto& candidate : candidates) {
+        if (!candidate.applicable(A)) {
+            continue;
+        }
+        auto [Q, R] = candidate.call(A);
+        double difference = std::max(maxDifference(Q, Q0), maxDifference(R, R0));
+        passed = report("qr", candidate.name, rows, cols, difference) && passed;
+    }
+    return passed;
+}
+
+// The dispatcher itself, whichever candidate the timing picked, against the first candidate
+bool checkDispatch(std::mt19937& rng) {
+    constexpr int N = 12;
+    Dense A = diagonallyDominantDense<double>(N, rng);
+    Matrix<N, N, double, AutoTunedPolicies<double>> matrix(A);
+
+    auto [L0, U0, rows0, cols0] = LUTuning<double>::candidates()[0].call(A);
+    auto [L, U] = matrix.luDecomposition();
+    bool passed = report("lu", AutoTunedLU<double>::selected(N), N, N, std::max(maxDifference(L.toVectorMatrix(), L0), maxDifference(U.toVectorMatrix(), U0)));
+
+    auto [Q0, R0] = QRTuning<double>::candidates()[0].call(A);
+    auto [Q, R] = matrix.qrDecomposition();
+    passed = report("qr", AutoTunedQR<double>::selected(N), N, N, std::max(maxDifference(Q.toVectorMatrix(), Q0), maxDifference(R.toVectorMatrix(), R0))) && passed;
+    return passed;
+}
+
+} // namespace
+
+int main() {
+    // Keep the calibration in memory instead of touching the user's tuning file
+    AutoTuneTable::instance().setPath("");
+
+    std::mt19937 rng(2024);
+    bool passed = true;
+    for (int n : {1, 5, 17, 32}) {
+        passed = checkLU(n, rng) && passed;
+    }
+    for (auto [rows, cols] : std::vector<std::pair<int, int>>{{1, 1}, {7, 7}, {16, 16}, {5, 9}, {9, 5}}) {
+        passed = checkQR(rows, cols, rng) && passed;
+    }
+    passed = checkDispatch(rng) && passed;
+    return passed ? 0 : 1;
+}
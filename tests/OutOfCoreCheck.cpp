@@ -0,0 +1,112 @@
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CholeskyPolicies.hpp"
+#include "MultiplicationPolicies.hpp"
+#include "OutOfCore.hpp"
+
+// Runs the out-of-core GEMM and Cholesky at the smallest memory budget the engine accepts,
+// on sizes that leave ragged edge tiles, and compares them with the in-memory policies.
+
+#if MATRIX_HAS_MMAP
+
+namespace {
+
+using Dense = std::vector<std::vector<double>>;
+
+constexpr std::size_t TileSize = 8;
+constexpr std::size_t MinimumBudget = OutOfCoreEngine<double>::MinimumTiles * TileSize * TileSize * sizeof(double);
+constexpr double Tolerance = 1e-10;
+
+Dense randomMatrix(int rows, int cols, std::mt19937& rng) {
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    Dense matrix(rows, std::vector<double>(cols));
+    for (auto& row : matrix) {
+        for (double& value : row) {
+            value = distribution(rng);
+        }
+    }
+    return matrix;
+}
+
+Dense positiveDefiniteMatrix(int n, std::mt19937& rng) {
+    Dense matrix = randomMatrix(n, n, rng);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < i; ++j) {
+            matrix[i][j] = matrix[j][i];
+        }
+        matrix[i][i] += n;
+    }
+    return matrix;
+}
+
+double maxDifference(const Dense& a, const Dense& b) {
+    double difference = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        for (std::size_t j = 0; j < a[i].size(); ++j) {
+            difference = std::max(difference, std::abs(a[i][j] - b[i][j]));
+        }
+    }
+    return difference;
+}
+
+std::string scratchPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("out_of_core_check_" + name + ".bin")).string();
+}
+
+bool report(const char* name, double difference, const OutOfCoreStats& stats) {
+    bool passed = difference <= Tolerance;
+    std::printf("%-10s %s  max difference %.3e, %llu tiles read, %llu written, %llu prefetch hits, peak %zu bytes\n",
+                name, passed ? "ok    " : "FAILED", difference,
+                static_cast<unsigned long long>(stats.tilesRead), static_cast<unsigned long long>(stats.tilesWritten),
+                static_cast<unsigned long long>(stats.prefetchHits), stats.peakResidentBytes);
+    return passed && stats.peakResidentBytes <= MinimumBudget;
+}
+
+bool checkMultiply(std::mt19937& rng) {
+    Dense a = randomMatrix(37, 21, rng);
+    Dense b = randomMatrix(21, 29, rng);
+    Dense expected = StandardMatrixMultiplication<double>::calculate(a, b);
+
+    auto A = TiledMatrix<double>::fromRows(scratchPath("a"), a, TileSize);
+    auto B = TiledMatrix<double>::fromRows(scratchPath("b"), b, TileSize);
+    TiledMatrix<double> C(scratchPath("c"), a.size(), b[0].size(), TileSize);
+    OutOfCoreEngine<double> engine(MinimumBudget);
+    engine.multiply(A, B, C);
+    return report("multiply", maxDifference(C.toVectorMatrix(), expected), engine.statistics());
+}
+
+bool checkCholesky(std::mt19937& rng) {
+    Dense a = positiveDefiniteMatrix(45, rng);
+    Dense expected = Cholesky<double>::calculate(a);
+
+    auto A = TiledMatrix<double>::fromRows(scratchPath("spd"), a, TileSize);
+    OutOfCoreEngine<double> engine(MinimumBudget);
+    engine.cholesky(A);
+    return report("cholesky", maxDifference(A.toVectorMatrix(), expected), engine.statistics());
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(2024);
+    bool passed = checkMultiply(rng);
+    passed = checkCholesky(rng) && passed;
+    for (const char* name : {"a", "b", "c", "spd"}) {
+        std::filesystem::remove(scratchPath(name));
+    }
+    return passed ? 0 : 1;
+}
+
+#else
+
+int main() {
+    std::puts("out-of-core matrices need mmap; nothing to check on this platform");
+    return 0;
+}
+
+#endif // MATRIX_HAS_MMAP